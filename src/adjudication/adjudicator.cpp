@@ -0,0 +1,78 @@
+#include "adjudicator.hpp"
+#include <bit>
+#include <cstdlib>
+#include "../boardsymmetry.hpp"
+#include "../engines/scoreengine.hpp"
+
+Adjudicator::Adjudicator(const AdjudicationRules &rules, Engine *engine1, Engine *engine2)
+    : m_rules(rules), m_engines{engine1, engine2} {
+    if (m_rules.endgame.max_empties > 0) {
+        m_solver = std::make_unique<EndgameSolver>(m_rules.endgame);
+    }
+}
+
+std::optional<GameOutcome> Adjudicator::adjudicate(const GameThingy &game) {
+    // Finished games are scored by play()
+    if (game.endpos.is_gameover()) {
+        return std::nullopt;
+    }
+
+    const int plies = static_cast<int>(game.history.size());
+    if (m_rules.max_plies.has_value() && plies >= m_rules.max_plies.value()) {
+        return GameOutcome::Draw;
+    }
+
+    if (m_rules.material.has_value()) {
+        const auto bits = board_bits(game.endpos);
+        const int margin = std::popcount(bits.black) - std::popcount(bits.white);
+        if (std::abs(margin) >= m_rules.material.value()) {
+            return margin > 0 ? GameOutcome::BlackWin : GameOutcome::WhiteWin;
+        }
+    }
+
+    // The engine that made the last move has a new score
+    const bool black_moved = game.endpos.get_turn() == libataxx::Side::White;
+    const int mover = black_moved ? 0 : 1;
+    const auto *engine = find_engine<ScoreEngine>(m_engines[mover]);
+    const auto score = engine != nullptr ? engine->score() : std::nullopt;
+    m_scores[mover] = score.has_value() ? std::optional(black_moved ? score.value() : -score.value()) : std::nullopt;
+    if (const auto outcome = adjudicate_scores(plies)) {
+        return outcome;
+    }
+
+    if (m_solver) {
+        return m_solver->solve(game.endpos);
+    }
+    return std::nullopt;
+}
+
+std::optional<GameOutcome> Adjudicator::adjudicate_scores(int plies) {
+    if (!m_scores[0].has_value() || !m_scores[1].has_value()) {
+        m_resign_plies = 0;
+        m_draw_plies = 0;
+        return std::nullopt;
+    }
+    const int black = m_scores[0].value();
+    const int white = m_scores[1].value();
+
+    if (m_rules.resign.has_value()) {
+        const auto &rule = m_rules.resign.value();
+        const int winner = black >= rule.score && white >= rule.score     ? 1
+                           : black <= -rule.score && white <= -rule.score ? -1
+                                                                          : 0;
+        m_resign_plies = winner != 0 && m_resign_plies * winner >= 0 ? m_resign_plies + winner : winner;
+        if (std::abs(m_resign_plies) >= 2 * rule.moves) {
+            return winner > 0 ? GameOutcome::BlackWin : GameOutcome::WhiteWin;
+        }
+    }
+
+    if (m_rules.draw.has_value() && plies >= m_rules.draw_after) {
+        const auto &rule = m_rules.draw.value();
+        const bool drawn = std::abs(black) <= rule.score && std::abs(white) <= rule.score;
+        m_draw_plies = drawn ? m_draw_plies + 1 : 0;
+        if (m_draw_plies >= 2 * rule.moves) {
+            return GameOutcome::Draw;
+        }
+    }
+    return std::nullopt;
+}
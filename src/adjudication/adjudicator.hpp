@@ -0,0 +1,53 @@
+#pragma once
+
+#include <../core/engine/engine.hpp>
+#include <../core/play.hpp>
+#include <array>
+#include <memory>
+#include <optional>
+#include "endgamesolver.hpp"
+
+struct ScoreRule {
+    // Centipawns
+    int score = 0;
+    // Moves of each engine in a row the rule has to hold for
+    int moves = 1;
+};
+
+// Rules the GUI applies on top of play()'s own adjudication
+struct AdjudicationRules {
+    // Loss for the side both engines score at or below -score
+    std::optional<ScoreRule> resign;
+    // Draw when both engines score within +-score, from draw_after plies on
+    std::optional<ScoreRule> draw;
+    int draw_after = 0;
+    // Win for the side with this many more pieces
+    std::optional<int> material;
+    // Draw after this many plies
+    std::optional<int> max_plies;
+    // Games end as soon as the solver proves their result
+    EndgameSettings endgame;
+};
+
+// Ends games early once their result is known or both engines agree on it. One per game, asked
+// after every move. Scores are only seen for engines wrapped in a ScoreEngine.
+class Adjudicator {
+   public:
+    // engine1 plays Black
+    Adjudicator(const AdjudicationRules &rules, Engine *engine1, Engine *engine2);
+
+    [[nodiscard]] std::optional<GameOutcome> adjudicate(const GameThingy &game);
+
+   private:
+    [[nodiscard]] std::optional<GameOutcome> adjudicate_scores(int plies);
+
+    AdjudicationRules m_rules;
+    std::array<Engine *, 2> m_engines;
+    // Last score of each engine from Black's point of view
+    std::array<std::optional<int>, 2> m_scores;
+    // Plies in a row that the resign or draw rule held, for resigning positive while Black wins
+    int m_resign_plies = 0;
+    int m_draw_plies = 0;
+    // Only there if the solver is enabled, its table lives for the whole game
+    std::unique_ptr<EndgameSolver> m_solver;
+};
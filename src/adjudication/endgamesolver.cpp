@@ -0,0 +1,209 @@
+#include "endgamesolver.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../searchboard.hpp"
+
+namespace {
+
+// Halfmoves without a single move until the game is drawn
+constexpr int halfmove_limit = 100;
+
+int result_of(const SearchBoard &board) {
+    const auto material = board.material();
+    return material > 0 ? 1 : material < 0 ? -1 : 0;
+}
+
+struct SolverShared {
+    TranspositionTable &tt;
+    std::uint64_t node_budget;
+    std::atomic<std::uint64_t> nodes = 0;
+    std::atomic<bool> stop = false;
+    std::mutex mutex{};
+    // Proven range of the result for the side to move at the root
+    int lower = -1;
+    int upper = 1;
+};
+
+// The full game tree is far too big: a double move doesn't fill a square, so the game needn't get
+// any shorter. Instead one side, the prover, only plays a double move when it has no single move,
+// while the other side may play anything. Nearly every move of the prover fills a square, so the
+// tree ends within a few plies per empty square. The prover can only do worse than with all its
+// moves, so the result of this game is a bound on the real result: a lower one for the prover, an
+// upper one for the other side. The result is proven once both bounds meet.
+class SolverThread {
+   public:
+    SolverThread(SolverShared &shared, int id) : m_shared(shared), m_id(id) {
+    }
+
+    // Helper threads start with the other prover, so both bounds are worked on from the start
+    void run(const SearchBoard &root) {
+        for (const bool root_proves : {m_id % 2 == 0, m_id % 2 != 0}) {
+            const int score = search(root, -1, 1, root_proves);
+            flush_nodes();
+            // An interrupted search returns nonsense
+            if (m_shared.stop) {
+                return;
+            }
+            std::lock_guard lock(m_shared.mutex);
+            if (root_proves) {
+                m_shared.lower = std::max(m_shared.lower, score);
+            } else {
+                m_shared.upper = std::min(m_shared.upper, score);
+            }
+            if (m_shared.lower == m_shared.upper) {
+                m_shared.stop = true;
+                return;
+            }
+        }
+    }
+
+   private:
+    void flush_nodes() {
+        if (m_shared.nodes.fetch_add(m_nodes) + m_nodes >= m_shared.node_budget) {
+            m_shared.stop = true;
+        }
+        m_nodes = 0;
+    }
+
+    // Win 1, draw 0 or loss -1 for the side to move, in the game where the prover plays singles
+    // whenever it can
+    int search(const SearchBoard &board, int alpha, int beta, bool prover_to_move) {
+        if (++m_nodes == 1024) {
+            flush_nodes();
+        }
+        if (m_shared.stop) {
+            return 0;
+        }
+
+        if (board.us == 0) {
+            return -1;
+        }
+        if (board.halfmoves >= halfmove_limit) {
+            return 0;
+        }
+        if (board.empty() == 0) {
+            return result_of(board);
+        }
+
+        // The halfmove clock decides draws, so it's part of the key here
+        auto key = board.hash() ^ (static_cast<std::uint64_t>(board.halfmoves) * 0x9e3779b97f4a7c15ULL);
+        key ^= prover_to_move ? 0x5851f42d4c957f2dULL : 0;
+        PackedMove tt_move = packed_pass;
+        if (const auto entry = m_shared.tt.probe(key)) {
+            tt_move = entry->move;
+            const int score = entry->score;
+            if (entry->bound == TranspositionTable::Bound::Exact ||
+                (entry->bound == TranspositionTable::Bound::Lower && score >= beta) ||
+                (entry->bound == TranspositionTable::Bound::Upper && score <= alpha)) {
+                return score;
+            }
+        }
+
+        MoveList moves;
+        int num_moves = board.generate(moves);
+        if (num_moves == 0) {
+            if (!board.opponent_can_move()) {
+                return result_of(board);
+            }
+            return -search(board.after(packed_pass), -beta, -alpha, !prover_to_move);
+        }
+        if (prover_to_move) {
+            // Singles come first, doubles only when there's no single
+            if (const int singles = std::popcount(dilate(board.us) & board.empty()); singles > 0) {
+                num_moves = singles;
+            }
+        }
+
+        // Moves that gain the most pieces first. Helper threads break ties differently so that
+        // they don't walk the same tree in the same order.
+        std::array<int, max_moves> order;
+        for (int i = 0; i < num_moves; ++i) {
+            const auto move = moves[i];
+            const int from = move >> 8;
+            const bool single = from == (move & 0xFF);
+            // A double move leaves a hole, which is bad next to the opponent's pieces
+            const bool opens_hole = !single && (single_move_masks[from] & board.them) != 0;
+            const int gain = 2 * board.captures(move) + (single ? 2 : 0) - (opens_hole ? 1 : 0) + 1;
+            const int tie_break = m_id == 0 ? 0 : (move * 31 + m_id * 97) & 0xFF;
+            order[i] = move == tt_move ? 1 << 30 : gain * 256 + tie_break;
+        }
+
+        const int original_alpha = alpha;
+        int best_score = -2;
+        PackedMove best_move = moves[0];
+        for (int i = 0; i < num_moves; ++i) {
+            const auto next = std::max_element(order.begin() + i, order.begin() + num_moves) - order.begin();
+            std::swap(order[i], order[next]);
+            std::swap(moves[i], moves[next]);
+
+            const int score = -search(board.after(moves[i]), -beta, -alpha, !prover_to_move);
+            if (m_shared.stop) {
+                return 0;
+            }
+            if (score > best_score) {
+                best_score = score;
+                best_move = moves[i];
+            }
+            alpha = std::max(alpha, score);
+            if (alpha >= beta) {
+                break;
+            }
+        }
+
+        const auto bound = best_score >= beta              ? TranspositionTable::Bound::Lower
+                           : best_score > original_alpha   ? TranspositionTable::Bound::Exact
+                                                           : TranspositionTable::Bound::Upper;
+        m_shared.tt.store(key,
+                          TranspositionTable::Entry{
+                              .move = best_move,
+                              .score = static_cast<std::int16_t>(best_score),
+                              .depth = 0,
+                              .bound = bound,
+                          });
+        return best_score;
+    }
+
+    SolverShared &m_shared;
+    int m_id;
+    std::uint64_t m_nodes = 0;
+};
+
+}  // namespace
+
+EndgameSolver::EndgameSolver(const EndgameSettings &settings) : m_settings(settings), m_tt(settings.hash_mb) {
+}
+
+std::optional<GameOutcome> EndgameSolver::solve(const libataxx::Position &pos) {
+    const auto root = SearchBoard::from(pos);
+    if (m_settings.max_empties <= 0 || std::popcount(root.empty()) > m_settings.max_empties) {
+        return std::nullopt;
+    }
+
+    m_tt.new_search();
+    SolverShared shared{.tt = m_tt, .node_budget = m_settings.nodes};
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < m_settings.threads; ++i) {
+        helpers.emplace_back([&shared, &root, i]() {
+            SolverThread(shared, i).run(root);
+        });
+    }
+    SolverThread(shared, 0).run(root);
+    shared.stop = true;
+    for (auto &helper : helpers) {
+        helper.join();
+    }
+
+    if (shared.lower != shared.upper) {
+        return std::nullopt;
+    }
+    if (shared.lower == 0) {
+        return GameOutcome::Draw;
+    }
+    const bool black_to_move = pos.get_turn() == libataxx::Side::Black;
+    return (shared.lower > 0) == black_to_move ? GameOutcome::BlackWin : GameOutcome::WhiteWin;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <../core/play.hpp>
+#include <cstdint>
+#include <libataxx/position.hpp>
+#include <optional>
+#include "../engines/transpositiontable.hpp"
+
+struct EndgameSettings {
+    // Positions with more empty squares aren't solved, 0 turns the solver off
+    int max_empties = 0;
+    // Budget of one attempt, a position that needs more is tried again after the next move
+    std::uint64_t nodes = 250000;
+    int threads = 1;
+    std::size_t hash_mb = 16;
+};
+
+// Searches positions with few empty squares to the end of the game. Only win, draw or loss are
+// searched for, not the final margin, which keeps the trees small. Positions that can't be proven
+// within the node budget aren't adjudicated, a wrong result is never returned.
+class EndgameSolver {
+   public:
+    explicit EndgameSolver(const EndgameSettings &settings);
+
+    // Result with perfect play from both sides, nullopt if the position has too many empty squares
+    // or couldn't be solved within the node budget. Solved positions stay in the table, so asking
+    // again after the next move is cheap.
+    [[nodiscard]] std::optional<GameOutcome> solve(const libataxx::Position &pos);
+
+   private:
+    EndgameSettings m_settings;
+    TranspositionTable m_tt;
+};
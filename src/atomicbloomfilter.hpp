@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+
+// Set of 64 bit keys in a fixed memory budget that many threads can insert into without locking.
+// Blocked Bloom filter: every key lives in one 64 bit word, so an insert is a single fetch_or and
+// touches one cache line. Can report a new key as present, never the other way round.
+class AtomicBloomFilter {
+   public:
+    explicit AtomicBloomFilter(std::size_t bytes)
+        : m_size(std::bit_floor(std::max<std::size_t>(bytes / sizeof(std::uint64_t), 64))),
+          m_words(std::make_unique<std::atomic<std::uint64_t>[]>(m_size)) {
+    }
+
+    // Returns false if the key was probably inserted before
+    bool insert(std::uint64_t key) {
+        key = mix(key);
+        const std::uint64_t bits = (1ULL << (key & 63)) | (1ULL << ((key >> 6) & 63)) | (1ULL << ((key >> 12) & 63)) |
+                                   (1ULL << ((key >> 18) & 63));
+        // The low bits pick the bits in the word, the high bits pick the word
+        auto &word = m_words[(key >> 24) & (m_size - 1)];
+        if ((word.load(std::memory_order_relaxed) & bits) == bits) {
+            return false;
+        }
+        return (word.fetch_or(bits, std::memory_order_relaxed) & bits) != bits;
+    }
+
+    [[nodiscard]] std::size_t bytes() const {
+        return m_size * sizeof(std::uint64_t);
+    }
+
+   private:
+    [[nodiscard]] static constexpr std::uint64_t mix(std::uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    std::size_t m_size;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> m_words;
+};
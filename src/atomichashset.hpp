@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+
+// Fixed size set of 64 bit keys that many threads can insert into without locking.
+// Open addressing with linear probing, a slot holding 0 is empty.
+class AtomicHashSet {
+   public:
+    enum class Insert
+    {
+        Inserted,
+        Present,
+        Full,
+    };
+
+    explicit AtomicHashSet(std::size_t capacity)
+        : m_size(std::bit_ceil(std::max<std::size_t>(capacity, 64))),
+          m_slots(std::make_unique<std::atomic<std::uint64_t>[]>(m_size)) {
+    }
+
+    Insert insert(std::uint64_t key) {
+        key = key == 0 ? 1 : key;
+        const std::size_t mask = m_size - 1;
+        std::size_t index = static_cast<std::size_t>(key) & mask;
+        for (std::size_t probes = 0; probes < m_size; ++probes) {
+            auto &slot = m_slots[index];
+            std::uint64_t current = slot.load(std::memory_order_relaxed);
+            if (current == 0 && slot.compare_exchange_strong(current, key, std::memory_order_relaxed)) {
+                return Insert::Inserted;
+            }
+            // Either already there or another thread took the slot first
+            if (current == key) {
+                return Insert::Present;
+            }
+            index = (index + 1) & mask;
+        }
+        return Insert::Full;
+    }
+
+    [[nodiscard]] std::size_t capacity() const {
+        return m_size;
+    }
+
+   private:
+    std::size_t m_size;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> m_slots;
+};
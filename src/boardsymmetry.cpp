@@ -0,0 +1,203 @@
+#include "boardsymmetry.hpp"
+#include <array>
+#include <libataxx/square.hpp>
+
+namespace {
+
+constexpr int board_size = 7;
+constexpr std::uint64_t rank_mask = (1ULL << board_size) - 1;
+
+constexpr int transform_coords(int file, int rank, Symmetry symmetry) {
+    constexpr int n = board_size - 1;
+    int f = file;
+    int r = rank;
+    switch (symmetry) {
+        case Symmetry::Identity:
+            break;
+        case Symmetry::Rotate90:
+            f = rank;
+            r = n - file;
+            break;
+        case Symmetry::Rotate180:
+            f = n - file;
+            r = n - rank;
+            break;
+        case Symmetry::Rotate270:
+            f = n - rank;
+            r = file;
+            break;
+        case Symmetry::MirrorFiles:
+            f = n - file;
+            break;
+        case Symmetry::MirrorRanks:
+            r = n - rank;
+            break;
+        case Symmetry::MirrorDiagonal:
+            f = rank;
+            r = file;
+            break;
+        case Symmetry::MirrorAntiDiagonal:
+            f = n - rank;
+            r = n - file;
+            break;
+    }
+    return r * board_size + f;
+}
+
+// For every symmetry and source rank, the image of each 7 bit rank pattern.
+// A full bitboard transform is then seven lookups OR'ed together.
+using RankTables = std::array<std::array<std::array<std::uint64_t, 1 << board_size>, board_size>, num_symmetries>;
+
+constexpr RankTables make_rank_tables() {
+    RankTables tables{};
+    for (int s = 0; s < num_symmetries; ++s) {
+        for (int rank = 0; rank < board_size; ++rank) {
+            for (int pattern = 0; pattern < (1 << board_size); ++pattern) {
+                std::uint64_t image = 0;
+                for (int file = 0; file < board_size; ++file) {
+                    if (pattern & (1 << file)) {
+                        image |= 1ULL << transform_coords(file, rank, static_cast<Symmetry>(s));
+                    }
+                }
+                tables[s][rank][pattern] = image;
+            }
+        }
+    }
+    return tables;
+}
+
+constexpr RankTables rank_tables = make_rank_tables();
+
+constexpr std::uint64_t mix(std::uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+int square_index(const libataxx::Square &sq) {
+    return static_cast<int>(sq.rank()) * board_size + static_cast<int>(sq.file());
+}
+
+libataxx::Square to_square(int index) {
+    return libataxx::Square(index % board_size, index / board_size);
+}
+
+}  // namespace
+
+BoardBits board_bits(const libataxx::Position &pos) {
+    BoardBits bits;
+    bits.turn = pos.get_turn();
+    for (int r = 0; r < board_size; ++r) {
+        for (int f = 0; f < board_size; ++f) {
+            const std::uint64_t bit = 1ULL << (r * board_size + f);
+            switch (pos.get(libataxx::Square(f, r))) {
+                case libataxx::Piece::Black:
+                    bits.black |= bit;
+                    break;
+                case libataxx::Piece::White:
+                    bits.white |= bit;
+                    break;
+                case libataxx::Piece::Gap:
+                    bits.gaps |= bit;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    return bits;
+}
+
+Symmetry inverse(Symmetry symmetry) {
+    switch (symmetry) {
+        case Symmetry::Rotate90:
+            return Symmetry::Rotate270;
+        case Symmetry::Rotate270:
+            return Symmetry::Rotate90;
+        default:
+            return symmetry;
+    }
+}
+
+int transform_square(int square, Symmetry symmetry) {
+    return transform_coords(square % board_size, square / board_size, symmetry);
+}
+
+std::uint64_t transform_bitboard(std::uint64_t bb, Symmetry symmetry) {
+    if (symmetry == Symmetry::Identity) {
+        return bb;
+    }
+    const auto &table = rank_tables[static_cast<int>(symmetry)];
+    std::uint64_t result = 0;
+    for (int rank = 0; rank < board_size; ++rank) {
+        result |= table[rank][(bb >> (rank * board_size)) & rank_mask];
+    }
+    return result;
+}
+
+BoardBits transform(const BoardBits &bits, Symmetry symmetry) {
+    return BoardBits{
+        .black = transform_bitboard(bits.black, symmetry),
+        .white = transform_bitboard(bits.white, symmetry),
+        .gaps = transform_bitboard(bits.gaps, symmetry),
+        .turn = bits.turn,
+    };
+}
+
+std::uint64_t position_hash(const BoardBits &bits) {
+    const std::uint64_t turn = bits.turn == libataxx::Side::Black ? 0x9e3779b97f4a7c15ULL : 0x3c6ef372fe94f82aULL;
+    return mix(bits.black ^ mix(bits.white ^ mix(bits.gaps ^ turn)));
+}
+
+CanonicalKey canonical_key(const BoardBits &bits) {
+    CanonicalKey key{.hash = position_hash(bits), .symmetry = Symmetry::Identity};
+    for (int s = 1; s < num_symmetries; ++s) {
+        const auto symmetry = static_cast<Symmetry>(s);
+        const auto hash = position_hash(transform(bits, symmetry));
+        if (hash < key.hash) {
+            key = CanonicalKey{.hash = hash, .symmetry = symmetry};
+        }
+    }
+    return key;
+}
+
+CanonicalKey canonical_key(const libataxx::Position &pos) {
+    return canonical_key(board_bits(pos));
+}
+
+std::uint64_t canonical_hash(const libataxx::Position &pos) {
+    return canonical_key(pos).hash;
+}
+
+PackedMove pack_move(const libataxx::Move &move) {
+    if (move == libataxx::Move::nullmove() || move == libataxx::Move::nomove()) {
+        return packed_pass;
+    }
+    const auto to = square_index(move.to());
+    const auto from = move.is_single() ? to : square_index(move.from());
+    return static_cast<PackedMove>((from << 8) | to);
+}
+
+libataxx::Move unpack_move(PackedMove move) {
+    if (move == packed_pass) {
+        return libataxx::Move::nullmove();
+    }
+    const int from = move >> 8;
+    const int to = move & 0xFF;
+    if (from == to) {
+        return libataxx::Move(to_square(to));
+    }
+    return libataxx::Move(to_square(from), to_square(to));
+}
+
+PackedMove transform_move(PackedMove move, Symmetry symmetry) {
+    if (move == packed_pass) {
+        return move;
+    }
+    const int from = transform_square(move >> 8, symmetry);
+    const int to = transform_square(move & 0xFF, symmetry);
+    return static_cast<PackedMove>((from << 8) | to);
+}
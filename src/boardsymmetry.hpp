@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <libataxx/move.hpp>
+#include <libataxx/position.hpp>
+
+// Board occupancy with square index rank * 7 + file, independent of the libataxx bitboard layout.
+// This is the layout used by every position-keyed store (opening books, explorer trees, caches).
+struct BoardBits {
+    std::uint64_t black = 0;
+    std::uint64_t white = 0;
+    std::uint64_t gaps = 0;
+    libataxx::Side turn = libataxx::Side::Black;
+
+    bool operator==(const BoardBits &) const = default;
+};
+
+// The eight symmetries of the square board. Each one maps a position to an equivalent one.
+enum class Symmetry : int
+{
+    Identity = 0,
+    Rotate90,
+    Rotate180,
+    Rotate270,
+    MirrorFiles,
+    MirrorRanks,
+    MirrorDiagonal,
+    MirrorAntiDiagonal,
+};
+
+constexpr int num_symmetries = 8;
+constexpr int board_squares = 49;
+
+// Moves in BoardBits square indices: (from << 8) | to, from == to for singles.
+using PackedMove = std::uint16_t;
+constexpr PackedMove packed_pass = 0xFFFF;
+
+[[nodiscard]] BoardBits board_bits(const libataxx::Position &pos);
+
+[[nodiscard]] Symmetry inverse(Symmetry symmetry);
+[[nodiscard]] int transform_square(int square, Symmetry symmetry);
+[[nodiscard]] std::uint64_t transform_bitboard(std::uint64_t bb, Symmetry symmetry);
+[[nodiscard]] BoardBits transform(const BoardBits &bits, Symmetry symmetry);
+
+// Orientation dependent hash of the exact position, side to move included.
+[[nodiscard]] std::uint64_t position_hash(const BoardBits &bits);
+
+struct CanonicalKey {
+    std::uint64_t hash = 0;
+    // Maps the hashed position onto the canonical orientation.
+    Symmetry symmetry = Symmetry::Identity;
+};
+
+// Minimum hash over the symmetry class, so all eight orientations of a position share one key.
+[[nodiscard]] CanonicalKey canonical_key(const BoardBits &bits);
+[[nodiscard]] CanonicalKey canonical_key(const libataxx::Position &pos);
+[[nodiscard]] std::uint64_t canonical_hash(const libataxx::Position &pos);
+
+[[nodiscard]] PackedMove pack_move(const libataxx::Move &move);
+[[nodiscard]] libataxx::Move unpack_move(PackedMove move);
+[[nodiscard]] PackedMove transform_move(PackedMove move, Symmetry symmetry);
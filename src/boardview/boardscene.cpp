@@ -34,6 +34,7 @@
 #include "graphicsboard.hpp"
 #include "graphicspiece.hpp"
 #include "pgn.hpp"
+#include "../tracer.hpp"
 
 namespace {
 
@@ -342,7 +343,8 @@ void BoardScene::add_move_arrow(const QPointF& sourcePos, const QPointF& targetP
 
 void BoardScene::apply_transition(const libataxx::Square& source, const libataxx::Square& target) {
     QParallelAnimationGroup* group = new QParallelAnimationGroup;
-    connect(group, &QParallelAnimationGroup::finished, [this, source, target]() {
+    connect(group, &QParallelAnimationGroup::finished, [this, source, target, begin = Tracer::Clock::now()]() {
+        Tracer::instance().complete("animation", "gui", begin, Tracer::Clock::now());
         this->m_squares->move_piece(source, target);
         for (const auto sq : (this->m_board.get_them() & libataxx::Bitboard(target).singles())) {
             this->m_squares->set_square(sq, this->create_piece(this->m_board.get(sq)));
@@ -24,6 +24,7 @@
 #include <QPainter>
 #include <QResizeEvent>
 #include <QTimer>
+#include "../tracer.hpp"
 
 BoardView::BoardView(QGraphicsScene* scene, QWidget* parent)
     : QGraphicsView(scene, parent), m_initialized(false), m_resize_timer(new QTimer(this)) {
@@ -61,6 +62,7 @@ int BoardView::heightForWidth(int width) const {
 }
 
 void BoardView::paintEvent(QPaintEvent* event) {
+    const TraceSpan span("paint", "gui");
     if (!m_resize_pixmap.isNull()) {
         QRect rect(viewport()->rect());
         qreal src_ar = qreal(m_resize_pixmap.width()) / m_resize_pixmap.height();
@@ -1,22 +1,90 @@
 #include "countdowntimer.hpp"
+#include <QTime>
+#include <algorithm>
+
+namespace {
+
+// Repaint intervals of a running clock: about the display's refresh rate when hundredths are
+// shown, otherwise often enough for the think time's tenths
+constexpr int fast_tick_ms = 16;
+constexpr int slow_tick_ms = 100;
+
+QString format_time(qint64 ms, qint64 low_time_ms) {
+    if (ms >= low_time_ms) {
+        return QTime(0, 0).addMSecs(std::min<qint64>(ms, 86399999)).toString("hh:mm:ss");
+    }
+    return QString("%1.%2").arg(ms / 1000, 2, 10, QChar('0')).arg(ms % 1000 / 10, 2, 10, QChar('0'));
+}
+
+}  // namespace
 
 CountdownTimer::CountdownTimer(QWidget *parent) : QLCDNumber(parent) {
     setSegmentStyle(Filled);
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
     connect(&m_timer, &QTimer::timeout, this, &CountdownTimer::tick);
 }
 
+qint64 CountdownTimer::think_time() const {
+    return m_running ? m_since.elapsed() : 0;
+}
+
+qint64 CountdownTimer::remaining() const {
+    return std::max<qint64>(0, m_time.value_or(0) - think_time());
+}
+
+int CountdownTimer::next_tick_ms() const {
+    if (m_time.has_value() && remaining() < low_time_ms) {
+        return fast_tick_ms;
+    }
+    return slow_tick_ms;
+}
+
 void CountdownTimer::start_clock() {
-    m_timer.start(1000);  // Start the timer to tick every second
+    m_running = true;
+    m_since.start();
+    tick();
 }
+
 void CountdownTimer::stop_clock() {
+    // The time used stays off the clock until the next set_time
+    m_time = m_time.has_value() ? std::optional<qint64>(remaining()) : std::nullopt;
+    m_running = false;
     m_timer.stop();
 }
 
-void CountdownTimer::set_time(QTime time) {
-    m_remaining_time = time;
-    display(m_remaining_time.toString("hh:mm:ss"));
+void CountdownTimer::set_time(std::optional<qint64> ms) {
+    m_time = ms;
+    if (m_running) {
+        m_since.start();
+    }
+    tick();
 }
+
 void CountdownTimer::tick() {
-    m_remaining_time = m_remaining_time.addSecs(-1);
-    display(m_remaining_time.toString("hh:mm:ss"));
-}
\ No newline at end of file
+    const auto text = m_time.has_value() ? format_time(remaining(), low_time_ms) : QString("23:59:59");
+    if (text != m_text) {
+        m_text = text;
+        display(text);
+    }
+    if (!m_running) {
+        return;
+    }
+
+    emit think_time_changed(think_time());
+    if (!m_suspended && (!m_time.has_value() || remaining() > 0)) {
+        m_timer.start(next_tick_ms());
+    }
+}
+
+void CountdownTimer::set_suspended(bool suspended) {
+    if (suspended == m_suspended) {
+        return;
+    }
+    m_suspended = suspended;
+    if (suspended) {
+        m_timer.stop();
+    } else {
+        tick();
+    }
+}
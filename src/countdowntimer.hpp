@@ -1,23 +1,45 @@
 #pragma once
 
+#include <QElapsedTimer>
 #include <QLCDNumber>
-#include <QTime>
 #include <QTimer>
+#include <optional>
 
+// A player's clock. The remaining time is computed from a monotonic start time, so it doesn't drift
+// however late the repaints come. Below low_time_ms it shows hundredths. It only repaints while it
+// runs, often enough for what it shows.
 class CountdownTimer : public QLCDNumber {
     Q_OBJECT
 
    public:
     CountdownTimer(QWidget *parent = nullptr);
 
+    // Time in milliseconds the side to move has been thinking, 0 when the clock isn't running
+    [[nodiscard]] qint64 think_time() const;
+
    public slots:
 
     void start_clock();
     void stop_clock();
-    void set_time(QTime time);
+    // No time means the side has no time limit, the clock then only measures the think time
+    void set_time(std::optional<qint64> ms);
     void tick();
+    // A suspended clock keeps counting but stops repainting
+    void set_suspended(bool suspended);
+
+   signals:
+    void think_time_changed(qint64 ms);
 
    private:
+    static constexpr qint64 low_time_ms = 10000;
+
+    [[nodiscard]] qint64 remaining() const;
+    [[nodiscard]] int next_tick_ms() const;
+
     QTimer m_timer;
-    QTime m_remaining_time;
-};
\ No newline at end of file
+    std::optional<qint64> m_time;
+    bool m_running = false;
+    bool m_suspended = false;
+    QElapsedTimer m_since;
+    QString m_text;
+};
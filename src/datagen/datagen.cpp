@@ -0,0 +1,248 @@
+#include "datagen.hpp"
+#include <algorithm>
+#include <atomic>
+#include <libataxx/position.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include "../atomicbloomfilter.hpp"
+#include "../boardsymmetry.hpp"
+#include "../engines/enginefactory.hpp"
+#include "../engines/scoreengine.hpp"
+#include "../metrics/metrics.hpp"
+#include "../searchboard.hpp"
+#include "shardwriter.hpp"
+
+namespace {
+
+libataxx::Position random_opening(const DatagenSettings &settings, std::mt19937_64 &rng) {
+    std::uniform_int_distribution<std::size_t> base_dist(0, settings.base_fens.size() - 1);
+    std::uniform_int_distribution<int> ply_dist(settings.min_plies, settings.max_plies);
+
+    // A random line can end the game early, take another one then
+    while (true) {
+        auto pos = libataxx::Position(settings.base_fens[base_dist(rng)]);
+        const int plies = ply_dist(rng);
+        for (int i = 0; i < plies && !pos.is_gameover(); ++i) {
+            const auto moves = pos.legal_moves();
+            std::uniform_int_distribution<std::size_t> move_dist(0, moves.size() - 1);
+            pos.makemove(moves[move_dist(rng)]);
+        }
+        if (!pos.is_gameover()) {
+            return pos;
+        }
+    }
+}
+
+std::int8_t result_for(libataxx::Result result, libataxx::Side side) {
+    if (result == libataxx::Result::BlackWin) {
+        return side == libataxx::Side::Black ? 1 : -1;
+    } else if (result == libataxx::Result::WhiteWin) {
+        return side == libataxx::Side::White ? 1 : -1;
+    }
+    return 0;
+}
+
+// An engine owned by one thread, with the score of its last search
+class Player {
+   public:
+    explicit Player(const EngineSettings &settings) : m_tracker(std::make_shared<ScoreTracker>()) {
+        auto engine = create_engine(settings, {}, [tracker = m_tracker](const std::string &line) {
+            tracker->on_line(line);
+        });
+        m_engine = std::make_shared<ScoreEngine>(std::move(engine), m_tracker);
+        m_engine->init();
+        for (const auto &[name, value] : settings.options) {
+            m_engine->set_option(name, value);
+        }
+        m_engine->isready();
+    }
+
+    ~Player() {
+        m_engine->quit();
+    }
+
+    Player(const Player &) = delete;
+    Player &operator=(const Player &) = delete;
+
+    void newgame() {
+        m_engine->newgame();
+    }
+
+    // The legal move the engine picked and its score
+    [[nodiscard]] std::pair<libataxx::Move, std::optional<int>> play(const libataxx::Position &pos,
+                                                                     const SearchSettings &tc) {
+        m_engine->position(pos);
+        const auto answer = m_engine->go(tc);
+        for (const auto &move : pos.legal_moves()) {
+            if (static_cast<std::string>(move) == answer) {
+                return {move, m_engine->score()};
+            }
+        }
+        throw std::runtime_error("Illegal move " + answer + " in " + pos.get_fen());
+    }
+
+   private:
+    std::shared_ptr<ScoreTracker> m_tracker;
+    std::shared_ptr<ScoreEngine> m_engine;
+};
+
+// Decides which positions are worth training on. The duplicate filter is shared, every thread
+// checks its own positions against it without locking.
+class PositionFilter {
+   public:
+    PositionFilter(const DatagenSettings &settings, AtomicBloomFilter *seen)
+        : m_skip_plies(settings.skip_plies), m_max_captures(settings.max_captures), m_seen(seen) {
+    }
+
+    // ply counts from the end of the opening
+    [[nodiscard]] bool keep(const libataxx::Position &pos, const libataxx::Move &move, int ply) const {
+        if (ply < m_skip_plies) {
+            return false;
+        }
+        if (SearchBoard::from(pos).captures(pack_move(move)) > m_max_captures) {
+            return false;
+        }
+        // Last, so positions the other filters drop don't take up room in the set
+        return m_seen == nullptr || m_seen->insert(pos.get_hash());
+    }
+
+   private:
+    int m_skip_plies;
+    int m_max_captures;
+    AtomicBloomFilter *m_seen;
+};
+
+TrainingRecord make_record(const libataxx::Position &pos, const libataxx::Move &move, int score) {
+    const auto bits = board_bits(pos);
+    TrainingRecord record;
+    record.black = bits.black;
+    record.white = bits.white;
+    record.gaps = bits.gaps;
+    record.score = static_cast<std::int16_t>(std::clamp(score, -32000, 32000));
+    record.move = pack_move(move);
+    record.turn = pos.get_turn() == libataxx::Side::Black ? 0 : 1;
+    record.halfmoves = static_cast<std::uint8_t>(std::min(pos.get_halfmoves(), 255));
+    return record;
+}
+
+}  // namespace
+
+DatagenProgress generate_data(const DatagenSettings &settings,
+                              std::function<void(const DatagenProgress &)> on_progress) {
+    if (settings.engines.empty() || settings.engines.size() > 2) {
+        throw std::invalid_argument("Data generation needs one or two engines");
+    }
+    if (settings.base_fens.empty()) {
+        throw std::invalid_argument("No base positions to start games from");
+    }
+    if (settings.min_plies < 0 || settings.max_plies < settings.min_plies) {
+        throw std::invalid_argument("Invalid ply range");
+    }
+
+    SearchSettings tc;
+    if (settings.depth > 0) {
+        tc.type = SearchSettings::Type::Depth;
+        tc.ply = settings.depth;
+    } else {
+        tc.type = SearchSettings::Type::Nodes;
+        tc.nodes = settings.nodes;
+    }
+
+    std::unique_ptr<AtomicBloomFilter> seen;
+    if (settings.dedup_mb > 0) {
+        seen = std::make_unique<AtomicBloomFilter>(settings.dedup_mb * 1024 * 1024);
+    }
+    const PositionFilter filter(settings, seen.get());
+
+    ShardWriter writer(settings.out, settings.shards, settings.queue_games);
+    std::atomic<std::size_t> next_game = 0;
+    // Set when a thread failed
+    std::atomic<bool> stop = false;
+    std::mutex progress_mutex;
+    DatagenProgress progress;
+    std::string error;
+
+    const unsigned num_threads = settings.threads > 0 ? settings.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            try {
+                std::mt19937_64 rng(settings.seed ^ (0x9E3779B97F4A7C15ULL * (t + 1)));
+                std::vector<std::unique_ptr<Player>> players;
+                for (const auto &engine : settings.engines) {
+                    players.push_back(std::make_unique<Player>(engine));
+                }
+
+                std::size_t game;
+                while (!stop && (game = next_game.fetch_add(1)) < settings.games) {
+                    // With two engines the first one plays black in even games
+                    Player &black = *players[game % players.size()];
+                    Player &white = *players[(game + 1) % players.size()];
+                    black.newgame();
+                    if (&white != &black) {
+                        white.newgame();
+                    }
+
+                    auto pos = random_opening(settings, rng);
+                    std::vector<TrainingRecord> records;
+                    std::uint64_t filtered = 0;
+                    int ply = 0;
+                    while (!pos.is_gameover() && !stop) {
+                        const auto moves = pos.legal_moves();
+                        if (moves.size() == 1 && moves.front() == libataxx::Move::nullmove()) {
+                            pos.makemove(moves.front());
+                            continue;
+                        }
+
+                        Player &player = pos.get_turn() == libataxx::Side::Black ? black : white;
+                        const auto [move, score] = player.play(pos, tc);
+                        if (score.has_value() && filter.keep(pos, move, ply)) {
+                            records.push_back(make_record(pos, move, score.value()));
+                        } else if (score.has_value()) {
+                            filtered++;
+                        }
+                        pos.makemove(move);
+                        ply++;
+                    }
+                    if (stop) {
+                        break;
+                    }
+
+                    const auto result = pos.get_result();
+                    for (auto &record : records) {
+                        record.result = result_for(result, record.turn == 0 ? libataxx::Side::Black : libataxx::Side::White);
+                    }
+                    const auto count = records.size();
+                    writer.push(std::move(records));
+                    Metrics::instance().add(Metrics::Counter::DatagenGames);
+                    Metrics::instance().add(Metrics::Counter::DatagenPositions, count);
+
+                    std::lock_guard lock(progress_mutex);
+                    progress.games++;
+                    progress.positions += count;
+                    progress.filtered += filtered;
+                    if (on_progress) {
+                        on_progress(progress);
+                    }
+                }
+            } catch (const std::exception &e) {
+                std::lock_guard lock(progress_mutex);
+                error = e.what();
+                stop = true;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    writer.close();
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+    return progress;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <../core/engine/settings.hpp>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct DatagenSettings {
+    // One engine plays itself, two engines play each other with colours alternating between games
+    std::vector<EngineSettings> engines;
+    // Search limit per move, depth is used instead of nodes when it is set
+    int nodes = 5000;
+    int depth = 0;
+    std::size_t games = 1000;
+    // Random plies played from the base position, picked uniformly in [min_plies, max_plies]
+    int min_plies = 6;
+    int max_plies = 10;
+    // Base positions, one picked at random for every game
+    std::vector<std::string> base_fens;
+    std::uint64_t seed = 0;
+    // 0 uses every core
+    unsigned threads = 0;
+
+    // Records go to "<out>-0.bin" ... "<out>-<shards - 1>.bin"
+    std::string out = "data";
+    int shards = 8;
+    // Finished games waiting for the writer before the players block
+    std::size_t queue_games = 256;
+
+    // Filters, run by the players before a game goes to the writer.
+    // Positions from the first skip_plies plies after the opening are dropped.
+    int skip_plies = 8;
+    // Positions whose move captures more than max_captures pieces are too tactical to learn from
+    int max_captures = 3;
+    // Memory for the duplicate filter shared by all threads, 0 keeps duplicates
+    std::size_t dedup_mb = 256;
+};
+
+struct DatagenProgress {
+    std::size_t games = 0;
+    std::uint64_t positions = 0;
+    // Positions the filters dropped
+    std::uint64_t filtered = 0;
+};
+
+// Plays self-play games on all threads and streams every searched position as a TrainingRecord
+// to the shard files. Passes, positions the engine reported no score for and positions the filters
+// drop are left out.
+// Returns the totals once all games are written.
+DatagenProgress generate_data(const DatagenSettings &settings,
+                              std::function<void(const DatagenProgress &)> on_progress = {});
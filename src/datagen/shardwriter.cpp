@@ -0,0 +1,103 @@
+#include "shardwriter.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include "../metrics/metrics.hpp"
+
+ShardWriter::ShardWriter(const std::string &prefix, int shards, std::size_t capacity)
+    : m_capacity(std::max<std::size_t>(capacity, 1)) {
+    if (shards < 1) {
+        throw std::invalid_argument("At least one shard is needed");
+    }
+    for (int i = 0; i < shards; ++i) {
+        const auto path = prefix + "-" + std::to_string(i) + ".bin";
+        m_files.emplace_back(path, std::ios::binary | std::ios::trunc);
+        if (!m_files.back().is_open()) {
+            throw std::runtime_error("Could not open " + path);
+        }
+    }
+    m_thread = std::thread(&ShardWriter::run, this);
+}
+
+ShardWriter::~ShardWriter() {
+    try {
+        close();
+    } catch (const std::exception &) {
+    }
+}
+
+void ShardWriter::push(std::vector<TrainingRecord> batch) {
+    std::unique_lock lock(m_mutex);
+    m_not_full.wait(lock, [this]() {
+        return m_queue.size() < m_capacity || m_closing || !m_error.empty();
+    });
+    if (!m_error.empty()) {
+        throw std::runtime_error(m_error);
+    }
+    if (m_closing) {
+        throw std::logic_error("Shard writer is closed");
+    }
+    m_queue.push_back(std::move(batch));
+    Metrics::instance().set(Metrics::Gauge::WriterQueue, static_cast<std::int64_t>(m_queue.size()));
+    m_not_empty.notify_one();
+}
+
+void ShardWriter::close() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_closing = true;
+    }
+    m_not_empty.notify_all();
+    m_not_full.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    for (auto &file : m_files) {
+        if (file.is_open()) {
+            file.close();
+        }
+    }
+    if (!m_error.empty()) {
+        throw std::runtime_error(m_error);
+    }
+}
+
+std::uint64_t ShardWriter::written() const {
+    std::lock_guard lock(m_mutex);
+    return m_written;
+}
+
+void ShardWriter::run() {
+    std::size_t shard = 0;
+    while (true) {
+        std::vector<TrainingRecord> batch;
+        {
+            std::unique_lock lock(m_mutex);
+            m_not_empty.wait(lock, [this]() {
+                return !m_queue.empty() || m_closing;
+            });
+            if (m_queue.empty()) {
+                return;
+            }
+            batch = std::move(m_queue.front());
+            m_queue.pop_front();
+            Metrics::instance().set(Metrics::Gauge::WriterQueue, static_cast<std::int64_t>(m_queue.size()));
+        }
+        m_not_full.notify_one();
+
+        // The file is only touched by this thread, the lock isn't held while writing
+        auto &file = m_files[shard];
+        shard = (shard + 1) % m_files.size();
+        file.write(reinterpret_cast<const char *>(batch.data()),
+                   static_cast<std::streamsize>(batch.size() * sizeof(TrainingRecord)));
+
+        std::lock_guard lock(m_mutex);
+        if (!file) {
+            m_error = "Could not write training data";
+            m_queue.clear();
+            m_not_full.notify_all();
+            return;
+        }
+        m_written += batch.size();
+    }
+}
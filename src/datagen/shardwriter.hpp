@@ -0,0 +1,46 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "trainingrecord.hpp"
+
+// Writes batches of records on a background thread, spreading them over shard files
+// "<prefix>-<n>.bin" in turn. The queue holds at most capacity batches, push() blocks
+// while it is full so generating threads can't run ahead of the disk.
+class ShardWriter {
+   public:
+    ShardWriter(const std::string &prefix, int shards, std::size_t capacity);
+    ~ShardWriter();
+
+    ShardWriter(const ShardWriter &) = delete;
+    ShardWriter &operator=(const ShardWriter &) = delete;
+
+    // Thread-safe. Throws if writing failed.
+    void push(std::vector<TrainingRecord> batch);
+
+    // Writes what is queued and closes the files. Throws if writing failed.
+    void close();
+
+    // Records written to disk so far
+    [[nodiscard]] std::uint64_t written() const;
+
+   private:
+    void run();
+
+    std::vector<std::ofstream> m_files;
+    std::size_t m_capacity;
+    std::deque<std::vector<TrainingRecord>> m_queue;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    bool m_closing = false;
+    std::string m_error;
+    std::uint64_t m_written = 0;
+    std::thread m_thread;
+};
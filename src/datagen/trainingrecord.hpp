@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+// One position of a self-play game, written as is (little-endian) to the datagen shard files.
+// Squares use the BoardBits layout, index rank * 7 + file.
+struct TrainingRecord {
+    std::uint64_t black = 0;
+    std::uint64_t white = 0;
+    std::uint64_t gaps = 0;
+    // Search score in centipawns from the point of view of the side to move, mate scores clamped
+    std::int16_t score = 0;
+    // PackedMove the engine played
+    std::uint16_t move = 0;
+    // 0 black, 1 white
+    std::uint8_t turn = 0;
+    // Game result from the point of view of the side to move: 1 win, 0 draw, -1 loss
+    std::int8_t result = 0;
+    std::uint8_t halfmoves = 0;
+    std::uint8_t reserved = 0;
+};
+
+static_assert(sizeof(TrainingRecord) == 32);
+static_assert(std::is_trivially_copyable_v<TrainingRecord>);
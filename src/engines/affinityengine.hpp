@@ -0,0 +1,33 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "../match/cpuaffinity.hpp"
+#include "engineproxy.hpp"
+
+// Runs the searches of an engine inside the GUI on the CPUs of its concurrency slot. The engine searches
+// on the calling thread, threads it starts for a search inherit the affinity. Between searches the
+// thread goes back to its own CPUs.
+class AffinityEngine : public EngineProxy {
+   public:
+    [[nodiscard]] AffinityEngine(std::shared_ptr<Engine> engine, std::vector<int> cpus, std::vector<int> home)
+        : EngineProxy(std::move(engine)), m_cpus(std::move(cpus)), m_home(std::move(home)) {
+    }
+
+    [[nodiscard]] auto go(const SearchSettings &settings) -> std::string override {
+        static_cast<void>(set_thread_affinity(m_cpus));
+        try {
+            auto move = m_engine->go(settings);
+            static_cast<void>(set_thread_affinity(m_home));
+            return move;
+        } catch (...) {
+            static_cast<void>(set_thread_affinity(m_home));
+            throw;
+        }
+    }
+
+   private:
+    std::vector<int> m_cpus;
+    std::vector<int> m_home;
+};
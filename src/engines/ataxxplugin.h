@@ -0,0 +1,87 @@
+/*
+ * C interface for engines loaded into the GUI as shared libraries, engines with
+ * "builtin": "plugin" and "path" pointing at the library. The library exports
+ * ataxx_plugin_entry(), everything else goes through the returned table.
+ *
+ * Squares are numbered rank * 7 + file, a1 = 0 and g7 = 48. Moves are packed
+ * as (from << 8) | to with from == to for single moves, 0xFFFF passes.
+ *
+ * One engine instance is only called from one thread at a time, except for
+ * stop(), which may be called from any thread at any time and ends a running
+ * go() as soon as possible.
+ */
+#ifndef ATAXX_PLUGIN_H
+#define ATAXX_PLUGIN_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ATAXX_PLUGIN_API_VERSION 1
+#define ATAXX_PLUGIN_PASS 0xFFFF
+
+#if defined(_WIN32)
+#define ATAXX_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define ATAXX_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+typedef struct ataxx_position {
+    uint64_t black;
+    uint64_t white;
+    uint64_t gaps;
+    /* 0 black, 1 white */
+    int32_t turn;
+    int32_t halfmoves;
+    int32_t fullmoves;
+} ataxx_position;
+
+typedef enum ataxx_limit_type {
+    ATAXX_LIMIT_TIME = 0,
+    ATAXX_LIMIT_MOVETIME = 1,
+    ATAXX_LIMIT_NODES = 2,
+    ATAXX_LIMIT_DEPTH = 3,
+} ataxx_limit_type;
+
+typedef struct ataxx_limits {
+    int32_t type;
+    /* Milliseconds */
+    int32_t btime;
+    int32_t wtime;
+    int32_t binc;
+    int32_t winc;
+    int32_t movetime;
+    int64_t nodes;
+    int32_t depth;
+} ataxx_limits;
+
+/* Receives UAI style "info ..." lines, user is the pointer given to create() */
+typedef void (*ataxx_info_callback)(void *user, const char *line);
+
+typedef struct ataxx_plugin {
+    /* ATAXX_PLUGIN_API_VERSION the plugin was built with */
+    uint32_t api_version;
+    const char *name;
+
+    void *(*create)(ataxx_info_callback info, void *user);
+    void (*destroy)(void *engine);
+    /* Returns 0 if the option is unknown */
+    int (*set_option)(void *engine, const char *name, const char *value);
+    void (*newgame)(void *engine);
+    void (*position)(void *engine, const ataxx_position *pos);
+    /* Blocks until the search is done and returns the packed move */
+    uint16_t (*go)(void *engine, const ataxx_limits *limits);
+    void (*stop)(void *engine);
+} ataxx_plugin;
+
+typedef const ataxx_plugin *(*ataxx_plugin_entry_fn)(void);
+
+ATAXX_PLUGIN_EXPORT const ataxx_plugin *ataxx_plugin_entry(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,39 @@
+#include "bookengine.hpp"
+
+namespace {
+
+int game_ply(const libataxx::Position &pos) {
+    return (pos.get_fullmoves() - 1) * 2 + (pos.get_turn() == libataxx::Side::White ? 1 : 0);
+}
+
+}  // namespace
+
+[[nodiscard]] BookEngine::BookEngine(std::shared_ptr<Engine> engine, std::shared_ptr<const OpeningBook> book, int depth)
+    : EngineProxy(std::move(engine)), m_book(std::move(book)), m_depth(depth), m_rng(std::random_device{}()) {
+}
+
+auto BookEngine::position(const libataxx::Position &pos) -> void {
+    m_position = pos;
+    if (!m_start_ply.has_value()) {
+        m_start_ply = game_ply(pos);
+    }
+    EngineProxy::position(pos);
+}
+
+[[nodiscard]] auto BookEngine::go(const SearchSettings &settings) -> std::string {
+    const int ply = game_ply(m_position) - m_start_ply.value_or(game_ply(m_position));
+    if (!m_out_of_book && (m_depth == 0 || ply < m_depth)) {
+        if (const auto move = m_book->pick(m_position, m_rng)) {
+            return static_cast<std::string>(move.value());
+        }
+        // Once out of book the game doesn't return to it
+        m_out_of_book = true;
+    }
+    return EngineProxy::go(settings);
+}
+
+auto BookEngine::newgame() -> void {
+    m_start_ply = std::nullopt;
+    m_out_of_book = false;
+    EngineProxy::newgame();
+}
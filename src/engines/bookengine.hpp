@@ -0,0 +1,26 @@
+#pragma once
+
+#include <memory>
+#include <random>
+#include "../openings/openingbook.hpp"
+#include "engineproxy.hpp"
+
+// Answers go() from an opening book without asking the wrapped engine while the game is in book.
+class BookEngine : public EngineProxy {
+   public:
+    [[nodiscard]] BookEngine(std::shared_ptr<Engine> engine, std::shared_ptr<const OpeningBook> book, int depth);
+
+    auto position(const libataxx::Position &pos) -> void override;
+
+    [[nodiscard]] auto go(const SearchSettings &settings) -> std::string override;
+
+    auto newgame() -> void override;
+
+   private:
+    std::shared_ptr<const OpeningBook> m_book;
+    int m_depth;
+    std::mt19937_64 m_rng;
+    libataxx::Position m_position;
+    std::optional<int> m_start_ply;
+    bool m_out_of_book = false;
+};
@@ -0,0 +1,20 @@
+#include "enginefactory.hpp"
+#include <../core/engine/create.hpp>
+#include "mockengine.hpp"
+#include "pluginengine.hpp"
+#include "referenceengine.hpp"
+
+std::shared_ptr<Engine> create_engine(const EngineSettings &settings,
+                                      Engine::callback_type send,
+                                      Engine::callback_type recv) {
+    if (settings.builtin == "reference") {
+        return std::make_shared<ReferenceEngine>(recv);
+    }
+    if (settings.builtin == "plugin") {
+        return std::make_shared<PluginEngine>(settings.path, recv);
+    }
+    if (settings.builtin == "mock") {
+        return std::make_shared<MockEngine>(recv);
+    }
+    return make_engine(settings, send, recv);
+}
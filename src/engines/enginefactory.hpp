@@ -0,0 +1,10 @@
+#pragma once
+
+#include <../core/engine/engine.hpp>
+#include <../core/engine/settings.hpp>
+#include <memory>
+
+// Engines built into the GUI, anything else goes to make_engine
+[[nodiscard]] std::shared_ptr<Engine> create_engine(const EngineSettings &settings,
+                                                    Engine::callback_type send,
+                                                    Engine::callback_type recv);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+
+// Mate scores are reported as centipawns beyond any real evaluation
+constexpr int mate_score = 100000;
+
+// Score in centipawns from an engine's "info ... score cp 35" or "score mate -3" line, from the
+// point of view of the side to move.
+[[nodiscard]] inline std::optional<int> parse_score(const std::string &line) {
+    std::istringstream in(line);
+    std::string token;
+    if (!(in >> token) || token != "info") {
+        return std::nullopt;
+    }
+    while (in >> token) {
+        if (token != "score") {
+            continue;
+        }
+        std::string type;
+        int value = 0;
+        if (!(in >> type >> value)) {
+            return std::nullopt;
+        }
+        if (type == "cp") {
+            return value;
+        } else if (type == "mate") {
+            return value > 0 ? mate_score - value : -mate_score - value;
+        }
+        return std::nullopt;
+    }
+    return std::nullopt;
+}
+
+// A plain number from an info line, e.g. parse_info_value(line, "depth")
+[[nodiscard]] inline std::optional<std::int64_t> parse_info_value(const std::string &line, const std::string &name) {
+    std::istringstream in(line);
+    std::string token;
+    if (!(in >> token) || token != "info") {
+        return std::nullopt;
+    }
+    while (in >> token) {
+        if (token == name) {
+            std::int64_t value = 0;
+            if (in >> value) {
+                return value;
+            }
+            return std::nullopt;
+        }
+    }
+    return std::nullopt;
+}
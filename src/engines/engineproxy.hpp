@@ -0,0 +1,74 @@
+#pragma once
+
+#include <../core/engine/engine.hpp>
+#include <../core/engine/process.hpp>
+#include <memory>
+
+// Forwards everything to a wrapped engine. Base class for engines that only intercept some calls.
+class EngineProxy : public Engine {
+   public:
+    [[nodiscard]] explicit EngineProxy(std::shared_ptr<Engine> engine) : Engine({}, {}), m_engine(std::move(engine)) {
+    }
+
+    auto init() -> void override {
+        m_engine->init();
+    }
+
+    auto position(const libataxx::Position &pos) -> void override {
+        m_engine->position(pos);
+    }
+
+    auto set_option(const std::string &name, const std::string &value) -> void override {
+        m_engine->set_option(name, value);
+    }
+
+    [[nodiscard]] auto go(const SearchSettings &settings) -> std::string override {
+        return m_engine->go(settings);
+    }
+
+    auto isready() -> void override {
+        m_engine->isready();
+    }
+
+    auto newgame() -> void override {
+        m_engine->newgame();
+    }
+
+    auto quit() -> void override {
+        m_engine->quit();
+    }
+
+    auto stop() -> void override {
+        m_engine->stop();
+    }
+
+    [[nodiscard]] auto wrapped() const -> const std::shared_ptr<Engine> & {
+        return m_engine;
+    }
+
+   protected:
+    // The wrapped engine tracks its own state
+    [[nodiscard]] auto is_running() -> bool override {
+        return false;
+    }
+
+    std::shared_ptr<Engine> m_engine;
+};
+
+// Looks through the chain of proxies for the first engine of type T, nullptr if there is none.
+template <typename T>
+[[nodiscard]] auto find_engine(Engine *engine) -> T * {
+    while (engine != nullptr) {
+        if (auto *found = dynamic_cast<T *>(engine)) {
+            return found;
+        }
+        auto *proxy = dynamic_cast<EngineProxy *>(engine);
+        engine = proxy != nullptr ? proxy->wrapped().get() : nullptr;
+    }
+    return nullptr;
+}
+
+// Looks through any proxies for the process behind an engine, nullptr for in-process engines.
+[[nodiscard]] inline auto process_engine(Engine *engine) -> ProcessEngine * {
+    return find_engine<ProcessEngine>(engine);
+}
@@ -0,0 +1,123 @@
+#include "latencyprofiler.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <libataxx/position.hpp>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "enginefactory.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int probe_movetime = 1;
+
+std::chrono::microseconds since(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+}
+
+std::shared_ptr<Engine> start_engine(const EngineSettings &settings) {
+    auto engine = create_engine(settings, {}, [](const std::string &) {
+    });
+    engine->init();
+    return engine;
+}
+
+void set_options(Engine &engine, const EngineSettings &settings) {
+    for (const auto &[name, value] : settings.options) {
+        engine.set_option(name, value);
+    }
+    engine.isready();
+}
+
+}  // namespace
+
+LatencyStats latency_stats(std::vector<std::chrono::microseconds> samples) {
+    if (samples.empty()) {
+        return {};
+    }
+    std::sort(samples.begin(), samples.end());
+    const auto at = [&samples](std::size_t percent) {
+        const auto rank = (percent * samples.size() + 99) / 100;
+        return samples[std::max<std::size_t>(rank, 1) - 1];
+    };
+    return {.min = samples.front(), .median = at(50), .p99 = at(99)};
+}
+
+std::string latency_table(const std::string &title,
+                          const std::vector<std::pair<std::string, LatencyStats>> &rows) {
+    constexpr int width = 10;
+    std::ostringstream out;
+    out << "  " << std::left << std::setw(width) << title << std::right << std::setw(width) << "min ms"
+        << std::setw(width) << "median ms" << std::setw(width) << "p99 ms" << '\n';
+    out << std::fixed << std::setprecision(3);
+    for (const auto &[name, stats] : rows) {
+        out << "  " << std::left << std::setw(width) << name << std::right;
+        for (const auto value : {stats.min, stats.median, stats.p99}) {
+            out << std::setw(width) << value.count() / 1000.0;
+        }
+        out << '\n';
+    }
+    return out.str();
+}
+
+EngineLatency profile_latency(const EngineSettings &engine,
+                              const LatencySettings &settings,
+                              std::function<void(const std::string &)> on_probe) {
+    const auto probe = [&on_probe](const std::string &name) {
+        if (on_probe) {
+            on_probe(name);
+        }
+    };
+    EngineLatency result;
+
+    probe("startup");
+    std::vector<std::chrono::microseconds> samples;
+    for (std::size_t i = 0; i < settings.startups; ++i) {
+        const auto start = Clock::now();
+        const auto e = start_engine(engine);
+        samples.push_back(since(start));
+        e->quit();
+    }
+    result.startup = latency_stats(std::move(samples));
+
+    const auto e = start_engine(engine);
+    set_options(*e, engine);
+    e->newgame();
+
+    probe("isready");
+    samples.clear();
+    for (std::size_t i = 0; i < settings.isready; ++i) {
+        const auto start = Clock::now();
+        e->isready();
+        samples.push_back(since(start));
+    }
+    result.isready = latency_stats(std::move(samples));
+
+    probe("go");
+    const libataxx::Position pos(settings.fen);
+    const auto legal = pos.legal_moves();
+    SearchSettings tc;
+    tc.type = SearchSettings::Type::Movetime;
+    tc.movetime = probe_movetime;
+    samples.clear();
+    for (std::size_t i = 0; i < settings.go; ++i) {
+        e->position(pos);
+        const auto start = Clock::now();
+        const auto move = e->go(tc);
+        const auto elapsed = since(start) - std::chrono::milliseconds(probe_movetime);
+        if (std::none_of(legal.begin(), legal.end(), [&move](const auto &m) {
+                return static_cast<std::string>(m) == move;
+            })) {
+            e->quit();
+            throw std::runtime_error(engine.name + " answered go with the illegal move " + move);
+        }
+        samples.push_back(std::max(elapsed, std::chrono::microseconds(0)));
+    }
+    result.go = latency_stats(std::move(samples));
+
+    e->quit();
+    return result;
+}
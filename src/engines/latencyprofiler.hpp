@@ -0,0 +1,48 @@
+#pragma once
+
+#include <../core/engine/settings.hpp>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct LatencySettings {
+    // Repetitions of each probe. Every startup spawns a new engine, so there are fewer of them.
+    std::size_t startups = 100;
+    std::size_t isready = 5000;
+    std::size_t go = 2000;
+    // Position searched by the go probe
+    std::string fen = "x5o/7/7/7/7/7/o5x x 0 1";
+};
+
+struct LatencyStats {
+    std::chrono::microseconds min{0};
+    std::chrono::microseconds median{0};
+    std::chrono::microseconds p99{0};
+};
+
+// Nearest-rank percentiles, all zero without samples
+[[nodiscard]] LatencyStats latency_stats(std::vector<std::chrono::microseconds> samples);
+
+// Table of the min, median and p99 in ms, one row per name under a header whose first column is title.
+// Every line is indented by two spaces and ends with a newline.
+[[nodiscard]] std::string latency_table(const std::string &title,
+                                        const std::vector<std::pair<std::string, LatencyStats>> &rows);
+
+struct EngineLatency {
+    // Spawning the engine until it answered uai with uaiok
+    LatencyStats startup;
+    // isready until readyok
+    LatencyStats isready;
+    // Time beyond the 1 ms of "go movetime 1" until bestmove
+    LatencyStats go;
+};
+
+// Runs the protocol probes against one engine, one probe after the other so they don't compete
+// with each other for the CPU. on_probe is called with the probe's name before it starts.
+// Throws if the engine fails to start or to answer.
+EngineLatency profile_latency(const EngineSettings &engine,
+                              const LatencySettings &settings,
+                              std::function<void(const std::string &)> on_probe = {});
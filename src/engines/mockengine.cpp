@@ -0,0 +1,139 @@
+#include "mockengine.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::atomic<std::uint64_t> next_instance = 0;
+
+// Share of the clock a real engine would spend on a move
+std::chrono::microseconds time_budget(const SearchSettings &settings, libataxx::Side turn) {
+    switch (settings.type) {
+        case SearchSettings::Type::Time: {
+            const bool black = turn == libataxx::Side::Black;
+            const auto time = black ? settings.btime : settings.wtime;
+            const auto inc = black ? settings.binc : settings.winc;
+            return std::chrono::milliseconds(std::max(time / 20 + inc / 2, 0));
+        }
+        case SearchSettings::Type::Movetime:
+            return std::chrono::milliseconds(settings.movetime);
+        default:
+            return std::chrono::microseconds::max();
+    }
+}
+
+}  // namespace
+
+MockEngine::MockEngine(callback_type on_info, std::optional<std::uint64_t> instance)
+    : Engine({}, {}), m_on_info(std::move(on_info)), m_instance(instance.has_value() ? *instance : next_instance++) {
+    reseed();
+}
+
+void MockEngine::reseed() {
+    m_rng.seed(m_seed ^ (0x9E3779B97F4A7C15ULL * (m_instance + 1)));
+}
+
+auto MockEngine::set_option(const std::string &name, const std::string &value) -> void {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    try {
+        if (lower == "latency") {
+            m_latency = std::max(std::stod(value), 0.0);
+        } else if (lower == "spread") {
+            m_spread = std::max(std::stod(value), 0.0);
+        } else if (lower == "info") {
+            m_info_rate = std::max(std::stod(value), 0.0);
+        } else if (lower == "crash") {
+            m_crash = std::clamp(std::stod(value), 0.0, 1.0);
+        } else if (lower == "hang") {
+            m_hang = std::clamp(std::stod(value), 0.0, 1.0);
+        } else if (lower == "seed") {
+            m_seed = std::stoull(value);
+            reseed();
+        }
+    } catch (const std::exception &) {
+        // Other engines ignore options they can't use, so does this one
+    }
+}
+
+auto MockEngine::stop() -> void {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+}
+
+[[nodiscard]] auto MockEngine::go(const SearchSettings &settings) -> std::string {
+    const auto moves = m_position.legal_moves();
+    if (moves.empty()) {
+        return static_cast<std::string>(libataxx::Move::nullmove());
+    }
+
+    // Everything random is drawn up front, so the info rate doesn't change what the engine does
+    double think_ms = m_latency;
+    if (m_spread > 0.0 && m_latency > 0.0) {
+        think_ms = std::lognormal_distribution<double>(std::log(m_latency), m_spread)(m_rng);
+    }
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    std::uniform_int_distribution<std::size_t> move_dist(0, moves.size() - 1);
+    const auto think = std::min(std::chrono::microseconds(static_cast<std::int64_t>(think_ms * 1000.0)),
+                                time_budget(settings, m_position.get_turn()));
+    const bool crash = chance(m_rng) < m_crash;
+    const bool hang = !crash && chance(m_rng) < m_hang;
+    const auto move = static_cast<std::string>(moves[move_dist(m_rng)]);
+    const int score = std::uniform_int_distribution<int>(-300, 300)(m_rng);
+
+    const auto start = Clock::now();
+    const auto deadline = start + think;
+    // Lines are sent in batches once per millisecond, a sleep per line couldn't keep up with high rates
+    constexpr auto tick = std::chrono::milliseconds(1);
+    std::uint64_t sent = 0;
+    const auto send_info = [&](Clock::time_point now) {
+        const auto elapsed = std::max<std::int64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - start).count(), 1);
+        const auto due = static_cast<std::uint64_t>(m_info_rate * static_cast<double>(elapsed) / 1e6);
+        for (; sent < due && m_on_info; ++sent) {
+            const auto nodes = (sent + 1) * 1000;
+            std::ostringstream info;
+            info << "info depth " << sent + 1 << " score cp " << score << " nodes " << nodes << " time "
+                 << elapsed / 1000 << " nps " << nodes * 1000000 / static_cast<std::uint64_t>(elapsed)
+                 << " pv " << move;
+            m_on_info(info.str());
+        }
+    };
+
+    std::unique_lock lock(m_mutex);
+    m_stop = false;
+    m_searching = true;
+    while (!m_stop) {
+        const auto now = Clock::now();
+        // The receiver may be slow, stop() mustn't wait for it
+        lock.unlock();
+        send_info(now);
+        lock.lock();
+        if (now >= deadline) {
+            break;
+        }
+        m_cv.wait_until(lock, std::min(deadline, now + tick));
+    }
+    if (hang) {
+        // Only the watchdog's stop ends this
+        m_cv.wait(lock, [this]() {
+            return m_stop;
+        });
+    }
+    m_searching = false;
+    if (crash) {
+        throw std::runtime_error("Mock engine crashed");
+    }
+    return move;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <../core/engine/engine.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+
+// Stand-in engine for load tests, selected with builtin = "mock". It plays random legal moves after a
+// think time drawn from a log-normal distribution, sends info lines at a fixed rate while it thinks
+// and crashes or hangs with a given probability per search. Options:
+//   latency  median think time in ms, capped by the time the engine has
+//   spread   sigma of the log-normal distribution, 0 thinks exactly latency ms
+//   info     info lines per second
+//   crash    probability that go throws
+//   hang     probability that go only returns after stop
+//   seed     engines created with the same seed behave the same, in the order they are created
+// "AtaxxGUI mock" runs it as a UAI engine process.
+class MockEngine : public Engine {
+   public:
+    // instance tells engines with the same seed apart, by default they are numbered in the order they are created
+    [[nodiscard]] explicit MockEngine(callback_type on_info = {},
+                                      std::optional<std::uint64_t> instance = std::nullopt);
+
+    auto init() -> void override {
+    }
+
+    auto position(const libataxx::Position &pos) -> void override {
+        m_position = pos;
+    }
+
+    auto set_option(const std::string &name, const std::string &value) -> void override;
+
+    [[nodiscard]] auto go(const SearchSettings &settings) -> std::string override;
+
+    auto isready() -> void override {
+    }
+
+    auto newgame() -> void override {
+    }
+
+    auto quit() -> void override {
+        stop();
+    }
+
+    auto stop() -> void override;
+
+   protected:
+    [[nodiscard]] auto is_running() -> bool override {
+        return m_searching;
+    }
+
+   private:
+    void reseed();
+
+    callback_type m_on_info;
+    libataxx::Position m_position;
+    double m_latency = 10.0;
+    double m_spread = 0.0;
+    double m_info_rate = 100.0;
+    double m_crash = 0.0;
+    double m_hang = 0.0;
+    std::uint64_t m_seed = 0;
+    // Engines with the same seed and instance make the same choices
+    std::uint64_t m_instance;
+    std::mt19937_64 m_rng;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+    std::atomic<bool> m_searching = false;
+};
@@ -0,0 +1,106 @@
+#include "pluginengine.hpp"
+#include <QLibrary>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include "../boardsymmetry.hpp"
+
+namespace {
+
+// Libraries stay loaded until the GUI exits, so no engine is left with code that was unloaded
+const ataxx_plugin *load_plugin(const std::string &path) {
+    static std::mutex mutex;
+    static std::map<std::string, const ataxx_plugin *> plugins;
+
+    std::lock_guard lock(mutex);
+    if (const auto it = plugins.find(path); it != plugins.end()) {
+        return it->second;
+    }
+
+    auto *library = new QLibrary(QString::fromStdString(path));
+    if (!library->load()) {
+        const auto error = library->errorString().toStdString();
+        delete library;
+        throw std::runtime_error("Couldn't load engine plugin " + path + ": " + error);
+    }
+    const auto entry = reinterpret_cast<ataxx_plugin_entry_fn>(library->resolve("ataxx_plugin_entry"));
+    const ataxx_plugin *plugin = entry != nullptr ? entry() : nullptr;
+    if (plugin == nullptr) {
+        throw std::runtime_error("No ataxx_plugin_entry in " + path);
+    }
+    if (plugin->api_version != ATAXX_PLUGIN_API_VERSION) {
+        throw std::runtime_error("Engine plugin " + path + " has API version " +
+                                 std::to_string(plugin->api_version) + ", expected " +
+                                 std::to_string(ATAXX_PLUGIN_API_VERSION));
+    }
+    plugins[path] = plugin;
+    return plugin;
+}
+
+ataxx_limits to_limits(const SearchSettings &settings) {
+    ataxx_limits limits{};
+    switch (settings.type) {
+        case SearchSettings::Type::Time:
+            limits.type = ATAXX_LIMIT_TIME;
+            break;
+        case SearchSettings::Type::Movetime:
+            limits.type = ATAXX_LIMIT_MOVETIME;
+            break;
+        case SearchSettings::Type::Nodes:
+            limits.type = ATAXX_LIMIT_NODES;
+            break;
+        case SearchSettings::Type::Depth:
+            limits.type = ATAXX_LIMIT_DEPTH;
+            break;
+    }
+    limits.btime = settings.btime;
+    limits.wtime = settings.wtime;
+    limits.binc = settings.binc;
+    limits.winc = settings.winc;
+    limits.movetime = settings.movetime;
+    limits.nodes = settings.nodes;
+    limits.depth = settings.ply;
+    return limits;
+}
+
+}  // namespace
+
+PluginEngine::PluginEngine(const std::string &path, callback_type on_info)
+    : Engine({}, {}), m_plugin(load_plugin(path)), m_on_info(std::move(on_info)) {
+    m_engine = m_plugin->create(&PluginEngine::forward_info, this);
+    if (m_engine == nullptr) {
+        throw std::runtime_error("Engine plugin " + path + " failed to create an engine");
+    }
+}
+
+PluginEngine::~PluginEngine() {
+    m_plugin->destroy(m_engine);
+}
+
+auto PluginEngine::position(const libataxx::Position &pos) -> void {
+    const auto bits = board_bits(pos);
+    const ataxx_position position{
+        .black = bits.black,
+        .white = bits.white,
+        .gaps = bits.gaps,
+        .turn = bits.turn == libataxx::Side::Black ? 0 : 1,
+        .halfmoves = pos.get_halfmoves(),
+        .fullmoves = pos.get_fullmoves(),
+    };
+    m_plugin->position(m_engine, &position);
+}
+
+[[nodiscard]] auto PluginEngine::go(const SearchSettings &settings) -> std::string {
+    const auto limits = to_limits(settings);
+    m_searching = true;
+    const auto move = m_plugin->go(m_engine, &limits);
+    m_searching = false;
+    return static_cast<std::string>(unpack_move(move));
+}
+
+void PluginEngine::forward_info(void *user, const char *line) {
+    auto *engine = static_cast<PluginEngine *>(user);
+    if (engine->m_on_info && line != nullptr) {
+        engine->m_on_info(line);
+    }
+}
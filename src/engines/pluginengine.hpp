@@ -0,0 +1,57 @@
+#pragma once
+
+#include <../core/engine/engine.hpp>
+#include <atomic>
+#include <string>
+#include "ataxxplugin.h"
+
+// Engine in a shared library that implements ataxxplugin.h. Positions and limits are passed as
+// structs and the move comes back from a direct call, there's no text protocol and no process.
+class PluginEngine : public Engine {
+   public:
+    // Throws if the library can't be loaded or was built for another API version
+    [[nodiscard]] PluginEngine(const std::string &path, callback_type on_info = {});
+    ~PluginEngine() override;
+
+    PluginEngine(const PluginEngine &) = delete;
+    PluginEngine &operator=(const PluginEngine &) = delete;
+
+    auto init() -> void override {
+    }
+
+    auto position(const libataxx::Position &pos) -> void override;
+
+    auto set_option(const std::string &name, const std::string &value) -> void override {
+        static_cast<void>(m_plugin->set_option(m_engine, name.c_str(), value.c_str()));
+    }
+
+    [[nodiscard]] auto go(const SearchSettings &settings) -> std::string override;
+
+    auto isready() -> void override {
+    }
+
+    auto newgame() -> void override {
+        m_plugin->newgame(m_engine);
+    }
+
+    auto quit() -> void override {
+        stop();
+    }
+
+    auto stop() -> void override {
+        m_plugin->stop(m_engine);
+    }
+
+   protected:
+    [[nodiscard]] auto is_running() -> bool override {
+        return m_searching;
+    }
+
+   private:
+    static void forward_info(void *user, const char *line);
+
+    const ataxx_plugin *m_plugin = nullptr;
+    void *m_engine = nullptr;
+    callback_type m_on_info;
+    std::atomic<bool> m_searching = false;
+};
@@ -0,0 +1,364 @@
+#include "referenceengine.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "../searchboard.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int max_ply = 128;
+constexpr int mate_value = 30000;
+constexpr int mate_bound = mate_value - max_ply;
+constexpr int infinity = mate_value + 1;
+constexpr int piece_value = 100;
+
+// Material only, the search finds the rest
+int evaluate(const SearchBoard &board) {
+    return piece_value * board.material();
+}
+
+// Score of a finished game, the side with more pieces wins
+int final_score(const SearchBoard &board, int ply) {
+    const auto material = board.material();
+    return material > 0 ? mate_value - ply : material < 0 ? -mate_value + ply : 0;
+}
+
+// Mate scores are stored relative to the node, so they stay valid wherever the position recurs
+int score_to_tt(int score, int ply) {
+    return score >= mate_bound ? score + ply : score <= -mate_bound ? score - ply : score;
+}
+
+int score_from_tt(int score, int ply) {
+    return score >= mate_bound ? score - ply : score <= -mate_bound ? score + ply : score;
+}
+
+struct Limits {
+    Clock::time_point start;
+    // Checked between iterations, no new iteration starts after it
+    std::optional<Clock::time_point> soft_deadline;
+    // Stops the search in the middle of an iteration
+    std::optional<Clock::time_point> hard_deadline;
+    std::uint64_t nodes = 0;
+    int depth = max_ply - 1;
+};
+
+Limits make_limits(const SearchSettings &settings, libataxx::Side turn) {
+    Limits limits;
+    limits.start = Clock::now();
+    switch (settings.type) {
+        case SearchSettings::Type::Time: {
+            const bool black = turn == libataxx::Side::Black;
+            // Leaves room for the GUI's own work between moves
+            const int remaining = std::max((black ? settings.btime : settings.wtime) - 20, 1);
+            const int inc = black ? settings.binc : settings.winc;
+            const int soft = std::min(remaining / 30 + inc * 3 / 4, remaining / 2);
+            const int hard = std::min(remaining / 4, soft * 4);
+            limits.soft_deadline = limits.start + std::chrono::milliseconds(std::max(soft, 1));
+            limits.hard_deadline = limits.start + std::chrono::milliseconds(std::max(hard, 1));
+            break;
+        }
+        case SearchSettings::Type::Movetime:
+            limits.soft_deadline = limits.start + std::chrono::milliseconds(settings.movetime);
+            limits.hard_deadline = limits.soft_deadline;
+            break;
+        case SearchSettings::Type::Nodes:
+            limits.nodes = static_cast<std::uint64_t>(std::max(settings.nodes, 1));
+            break;
+        case SearchSettings::Type::Depth:
+            limits.depth = std::clamp(settings.ply, 1, max_ply - 1);
+            break;
+    }
+    return limits;
+}
+
+class SearchThread;
+
+// Shared by all threads of one search
+struct SearchShared {
+    TranspositionTable &tt;
+    std::atomic<bool> &stop;
+    const Limits &limits;
+    std::vector<std::unique_ptr<SearchThread>> threads;
+
+    [[nodiscard]] std::uint64_t nodes() const;
+};
+
+class SearchThread {
+   public:
+    SearchThread(SearchShared &shared, int id) : m_shared(shared), m_id(id) {
+    }
+
+    // Iterative deepening until the limits are reached or the search is stopped. Helper threads
+    // start at different depths so that they don't all search the same tree in the same order.
+    void iterate(const SearchBoard &root, const std::function<void(int depth, int score)> &on_iteration) {
+        for (int depth = 1 + (m_id & 1); depth <= m_shared.limits.depth; ++depth) {
+            const int score = search(root, -infinity, infinity, depth, 0);
+            if (m_shared.stop) {
+                break;
+            }
+            m_best_move = m_root_move;
+            m_completed_depth = depth;
+            if (on_iteration) {
+                on_iteration(depth, score);
+            }
+            if (m_id == 0 && m_shared.limits.soft_deadline && Clock::now() >= *m_shared.limits.soft_deadline) {
+                break;
+            }
+        }
+    }
+
+    [[nodiscard]] std::uint64_t nodes() const {
+        return m_nodes.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] PackedMove best_move() const {
+        return m_best_move;
+    }
+
+    [[nodiscard]] int completed_depth() const {
+        return m_completed_depth;
+    }
+
+   private:
+    // Only the main thread looks at the clock and the node count, helpers follow its stop
+    void check_limits() {
+        const auto &limits = m_shared.limits;
+        if (limits.hard_deadline && Clock::now() >= *limits.hard_deadline) {
+            m_shared.stop = true;
+        }
+        if (limits.nodes != 0 && m_shared.nodes() >= limits.nodes) {
+            m_shared.stop = true;
+        }
+    }
+
+    int search(const SearchBoard &board, int alpha, int beta, int depth, int ply) {
+        const auto nodes = m_nodes.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (m_id == 0 && (nodes & 1023) == 0) {
+            check_limits();
+        }
+        if (m_shared.stop) {
+            return 0;
+        }
+
+        if (board.us == 0) {
+            return -mate_value + ply;
+        }
+        if (ply > 0 && board.halfmoves >= 100) {
+            return 0;
+        }
+        if (depth <= 0 || ply >= max_ply) {
+            return evaluate(board);
+        }
+
+        const auto key = board.hash();
+        PackedMove tt_move = packed_pass;
+        if (const auto entry = m_shared.tt.probe(key)) {
+            tt_move = entry->move;
+            const int score = score_from_tt(entry->score, ply);
+            if (ply > 0 && entry->depth >= depth &&
+                (entry->bound == TranspositionTable::Bound::Exact ||
+                 (entry->bound == TranspositionTable::Bound::Lower && score >= beta) ||
+                 (entry->bound == TranspositionTable::Bound::Upper && score <= alpha))) {
+                return score;
+            }
+        }
+
+        MoveList moves;
+        const int num_moves = board.generate(moves);
+        if (num_moves == 0) {
+            if (!board.opponent_can_move()) {
+                return final_score(board, ply);
+            }
+            return -search(board.after(packed_pass), -beta, -alpha, depth, ply + 1);
+        }
+
+        std::array<int, max_moves> order;
+        for (int i = 0; i < num_moves; ++i) {
+            const auto move = moves[i];
+            const bool single = (move >> 8) == (move & 0xFF);
+            order[i] = move == tt_move ? 1 << 30
+                                       : (2 * board.captures(move) + (single ? 1 : 0)) * 65536 +
+                                             m_history[move >> 8][move & 0xFF];
+        }
+
+        const int original_alpha = alpha;
+        int best_score = -infinity;
+        PackedMove best_move = moves[0];
+        for (int i = 0; i < num_moves; ++i) {
+            // Selection sort as we go, most nodes cut off after the first few moves
+            const auto next = std::max_element(order.begin() + i, order.begin() + num_moves) - order.begin();
+            std::swap(order[i], order[next]);
+            std::swap(moves[i], moves[next]);
+            const auto move = moves[i];
+            const auto child = board.after(move);
+
+            int score;
+            if (i == 0) {
+                score = -search(child, -beta, -alpha, depth - 1, ply + 1);
+            } else {
+                // Late quiet moves are searched shallower first, and with a null window
+                const bool quiet = board.captures(move) == 0;
+                const int reduction = depth >= 3 && i >= 4 && quiet ? (i >= 12 ? 2 : 1) : 0;
+                score = -search(child, -alpha - 1, -alpha, depth - 1 - reduction, ply + 1);
+                if (score > alpha && reduction > 0) {
+                    score = -search(child, -alpha - 1, -alpha, depth - 1, ply + 1);
+                }
+                if (score > alpha && score < beta) {
+                    score = -search(child, -beta, -alpha, depth - 1, ply + 1);
+                }
+            }
+            if (m_shared.stop) {
+                return 0;
+            }
+
+            if (score > best_score) {
+                best_score = score;
+                best_move = move;
+                if (ply == 0) {
+                    m_root_move = move;
+                }
+            }
+            if (score > alpha) {
+                alpha = score;
+            }
+            if (alpha >= beta) {
+                auto &history = m_history[move >> 8][move & 0xFF];
+                history = std::min(history + depth * depth, 60000);
+                break;
+            }
+        }
+
+        const auto bound = best_score >= beta              ? TranspositionTable::Bound::Lower
+                           : best_score > original_alpha   ? TranspositionTable::Bound::Exact
+                                                           : TranspositionTable::Bound::Upper;
+        m_shared.tt.store(key,
+                          TranspositionTable::Entry{
+                              .move = best_move,
+                              .score = static_cast<std::int16_t>(score_to_tt(best_score, ply)),
+                              .depth = static_cast<std::uint8_t>(depth),
+                              .bound = bound,
+                          });
+        return best_score;
+    }
+
+    SearchShared &m_shared;
+    int m_id;
+    std::atomic<std::uint64_t> m_nodes = 0;
+    std::array<std::array<int, board_squares>, board_squares> m_history{};
+    PackedMove m_root_move = packed_pass;
+    PackedMove m_best_move = packed_pass;
+    int m_completed_depth = 0;
+};
+
+std::uint64_t SearchShared::nodes() const {
+    std::uint64_t total = 0;
+    for (const auto &thread : threads) {
+        total += thread->nodes();
+    }
+    return total;
+}
+
+// Follows the best moves stored in the table, as long as they are legal
+std::string principal_variation(const TranspositionTable &tt, SearchBoard board, PackedMove first, int max_length) {
+    std::string pv = static_cast<std::string>(unpack_move(first));
+    board = board.after(first);
+    for (int i = 1; i < max_length; ++i) {
+        const auto entry = tt.probe(board.hash());
+        if (!entry) {
+            break;
+        }
+        MoveList moves;
+        const int num_moves = board.generate(moves);
+        if (std::find(moves.begin(), moves.begin() + num_moves, entry->move) == moves.begin() + num_moves) {
+            break;
+        }
+        pv += " " + static_cast<std::string>(unpack_move(entry->move));
+        board = board.after(entry->move);
+    }
+    return pv;
+}
+
+}  // namespace
+
+ReferenceEngine::ReferenceEngine(callback_type on_info) : Engine({}, {}), m_on_info(std::move(on_info)), m_tt(16) {
+}
+
+auto ReferenceEngine::set_option(const std::string &name, const std::string &value) -> void {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    try {
+        if (lower == "threads") {
+            m_threads = std::clamp(std::stoi(value), 1, 256);
+        } else if (lower == "hash") {
+            m_tt.resize(static_cast<std::size_t>(std::clamp(std::stoi(value), 1, 65536)));
+        }
+    } catch (const std::exception &) {
+        // Other engines ignore options they can't use, so does this one
+    }
+}
+
+[[nodiscard]] auto ReferenceEngine::go(const SearchSettings &settings) -> std::string {
+    const auto root = SearchBoard::from(m_position);
+    MoveList moves;
+    const int num_moves = root.generate(moves);
+    if (num_moves == 0) {
+        return static_cast<std::string>(libataxx::Move::nullmove());
+    }
+
+    m_stop = false;
+    m_searching = true;
+    m_tt.new_search();
+    const auto limits = make_limits(settings, m_position.get_turn());
+    SearchShared shared{.tt = m_tt, .stop = m_stop, .limits = limits, .threads = {}};
+    for (int i = 0; i < m_threads; ++i) {
+        shared.threads.push_back(std::make_unique<SearchThread>(shared, i));
+    }
+
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < m_threads; ++i) {
+        helpers.emplace_back([&shared, &root, i]() {
+            shared.threads[i]->iterate(root, {});
+        });
+    }
+    auto &main_thread = *shared.threads[0];
+    main_thread.iterate(root, [&](int depth, int score) {
+        if (!m_on_info) {
+            return;
+        }
+        const auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - limits.start).count();
+        const auto nodes = shared.nodes();
+        std::ostringstream info;
+        info << "info depth " << depth;
+        if (std::abs(score) >= mate_bound) {
+            const int plies = mate_value - std::abs(score);
+            info << " score mate " << (score > 0 ? (plies + 1) / 2 : -(plies + 1) / 2);
+        } else {
+            info << " score cp " << score;
+        }
+        info << " nodes " << nodes << " time " << elapsed << " nps " << nodes * 1000 / std::max<std::int64_t>(elapsed, 1)
+             << " pv " << principal_variation(m_tt, root, main_thread.best_move(), depth);
+        m_on_info(info.str());
+    });
+    m_stop = true;
+    for (auto &helper : helpers) {
+        helper.join();
+    }
+    m_searching = false;
+
+    // Without a finished iteration the first move is as good as any
+    const auto move = main_thread.completed_depth() > 0 ? main_thread.best_move() : moves[0];
+    return static_cast<std::string>(unpack_move(move));
+}
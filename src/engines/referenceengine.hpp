@@ -0,0 +1,55 @@
+#pragma once
+
+#include <../core/engine/engine.hpp>
+#include <atomic>
+#include <functional>
+#include <string>
+#include "transpositiontable.hpp"
+
+// Alpha-beta engine that runs inside the GUI, selected with builtin = "reference". Iterative
+// deepening with Lazy SMP: every thread searches the same root and they share their results through
+// the transposition table. Options are "threads" and "hash" (MB).
+class ReferenceEngine : public Engine {
+   public:
+    // Info lines go to on_info like the output of an engine process
+    [[nodiscard]] explicit ReferenceEngine(callback_type on_info = {});
+
+    auto init() -> void override {
+    }
+
+    auto position(const libataxx::Position &pos) -> void override {
+        m_position = pos;
+    }
+
+    auto set_option(const std::string &name, const std::string &value) -> void override;
+
+    [[nodiscard]] auto go(const SearchSettings &settings) -> std::string override;
+
+    auto isready() -> void override {
+    }
+
+    auto newgame() -> void override {
+        m_tt.clear();
+    }
+
+    auto quit() -> void override {
+        stop();
+    }
+
+    auto stop() -> void override {
+        m_stop = true;
+    }
+
+   protected:
+    [[nodiscard]] auto is_running() -> bool override {
+        return m_searching;
+    }
+
+   private:
+    callback_type m_on_info;
+    libataxx::Position m_position;
+    TranspositionTable m_tt;
+    int m_threads = 1;
+    std::atomic<bool> m_stop = false;
+    std::atomic<bool> m_searching = false;
+};
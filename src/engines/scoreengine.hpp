@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include "../metrics/metrics.hpp"
+#include "engineinfo.hpp"
+#include "engineproxy.hpp"
+
+// Collects the score, depth and speed from an engine's info lines, fed by the engine's recv callback
+class ScoreTracker {
+   public:
+    void on_line(const std::string &line) {
+        const auto score = parse_score(line);
+        const auto depth = parse_info_value(line, "depth");
+        const auto nps = parse_info_value(line, "nps");
+        std::lock_guard lock(m_mutex);
+        m_score = score.has_value() ? score : m_score;
+        m_depth = depth.has_value() ? std::optional<int>(static_cast<int>(depth.value())) : m_depth;
+        m_nps = nps.has_value() ? nps : m_nps;
+    }
+
+    void reset() {
+        std::lock_guard lock(m_mutex);
+        m_score = std::nullopt;
+        m_depth = std::nullopt;
+        m_nps = std::nullopt;
+    }
+
+    [[nodiscard]] std::optional<int> score() const {
+        std::lock_guard lock(m_mutex);
+        return m_score;
+    }
+
+    [[nodiscard]] std::optional<int> depth() const {
+        std::lock_guard lock(m_mutex);
+        return m_depth;
+    }
+
+    [[nodiscard]] std::optional<std::int64_t> nps() const {
+        std::lock_guard lock(m_mutex);
+        return m_nps;
+    }
+
+   private:
+    mutable std::mutex m_mutex;
+    std::optional<int> m_score;
+    std::optional<int> m_depth;
+    std::optional<std::int64_t> m_nps;
+};
+
+// Knows the score of the engine's last search, from the point of view of the side that moved.
+// A move that didn't come from a search, e.g. from an opening book, has no score.
+// The depth and speed of every search go to the metrics.
+class ScoreEngine : public EngineProxy {
+   public:
+    [[nodiscard]] ScoreEngine(std::shared_ptr<Engine> engine, std::shared_ptr<ScoreTracker> tracker)
+        : EngineProxy(std::move(engine)), m_tracker(std::move(tracker)) {
+    }
+
+    [[nodiscard]] auto go(const SearchSettings &settings) -> std::string override {
+        m_tracker->reset();
+        auto move = EngineProxy::go(settings);
+        Metrics::instance().observe_search(m_tracker->depth(), m_tracker->nps());
+        return move;
+    }
+
+    [[nodiscard]] auto score() const -> std::optional<int> {
+        return m_tracker->score();
+    }
+
+   private:
+    std::shared_ptr<ScoreTracker> m_tracker;
+};
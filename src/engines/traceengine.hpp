@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include "../tracer.hpp"
+#include "engineproxy.hpp"
+
+// Records the engine's handshake and every search on the tracer's timeline.
+// Only put in front of engines while a trace is recorded.
+class TraceEngine : public EngineProxy {
+   public:
+    [[nodiscard]] TraceEngine(std::shared_ptr<Engine> engine, std::string name)
+        : EngineProxy(std::move(engine)), m_name(std::move(name)) {
+    }
+
+    auto init() -> void override {
+        const TraceSpan span("handshake", "engine", m_name);
+        m_engine->init();
+    }
+
+    auto isready() -> void override {
+        const TraceSpan span("isready", "engine", m_name);
+        m_engine->isready();
+    }
+
+    auto newgame() -> void override {
+        const TraceSpan span("newgame", "engine", m_name);
+        m_engine->newgame();
+    }
+
+    [[nodiscard]] auto go(const SearchSettings &settings) -> std::string override {
+        const TraceSpan span("think", "engine", m_name);
+        return m_engine->go(settings);
+    }
+
+   private:
+    std::string m_name;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include "../boardsymmetry.hpp"
+
+// Transposition table shared by all search threads without locks. Each slot stores key ^ data next
+// to data, a slot torn by two threads writing at once fails the key check and reads as a miss.
+class TranspositionTable {
+   public:
+    enum class Bound : std::uint8_t
+    {
+        Exact,
+        Lower,
+        Upper,
+    };
+
+    struct Entry {
+        PackedMove move = packed_pass;
+        std::int16_t score = 0;
+        std::uint8_t depth = 0;
+        Bound bound = Bound::Exact;
+    };
+
+    explicit TranspositionTable(std::size_t megabytes) {
+        resize(megabytes);
+    }
+
+    // Not thread-safe, only while no search runs
+    void resize(std::size_t megabytes) {
+        const std::size_t num_slots = std::max<std::size_t>(megabytes, 1) * 1024 * 1024 / sizeof(Slot);
+        m_size = std::bit_floor(num_slots);
+        m_slots = std::make_unique<Slot[]>(m_size);
+    }
+
+    // Not thread-safe, only while no search runs
+    void clear() {
+        for (std::size_t i = 0; i < m_size; ++i) {
+            m_slots[i].check.store(0, std::memory_order_relaxed);
+            m_slots[i].data.store(0, std::memory_order_relaxed);
+        }
+        m_generation = 0;
+    }
+
+    // Entries from earlier searches are replaced first
+    void new_search() {
+        m_generation = (m_generation + 1) & generation_mask;
+    }
+
+    [[nodiscard]] std::optional<Entry> probe(std::uint64_t key) const {
+        const auto &slot = m_slots[key & (m_size - 1)];
+        const auto data = slot.data.load(std::memory_order_relaxed);
+        if (data == 0 || (slot.check.load(std::memory_order_relaxed) ^ data) != key) {
+            return std::nullopt;
+        }
+        return unpack(data);
+    }
+
+    void store(std::uint64_t key, const Entry &entry) {
+        auto &slot = m_slots[key & (m_size - 1)];
+        const auto old_data = slot.data.load(std::memory_order_relaxed);
+        const bool same_key = (slot.check.load(std::memory_order_relaxed) ^ old_data) == key;
+        if (old_data != 0 && !same_key && ((old_data >> 42) & generation_mask) == m_generation &&
+            unpack(old_data).depth > entry.depth) {
+            return;
+        }
+        const auto data = pack(entry);
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+        slot.data.store(data, std::memory_order_relaxed);
+    }
+
+   private:
+    static constexpr std::uint64_t generation_mask = 0x3F;
+
+    struct Slot {
+        std::atomic<std::uint64_t> check{0};
+        std::atomic<std::uint64_t> data{0};
+    };
+
+    // move:16 score:16 depth:8 bound:2 generation:6, bit 48 marks a used slot
+    [[nodiscard]] std::uint64_t pack(const Entry &entry) const {
+        return std::uint64_t{entry.move} | (std::uint64_t{static_cast<std::uint16_t>(entry.score)} << 16) |
+               (std::uint64_t{entry.depth} << 32) | (std::uint64_t{static_cast<std::uint8_t>(entry.bound)} << 40) |
+               (m_generation << 42) | (1ULL << 48);
+    }
+
+    [[nodiscard]] static Entry unpack(std::uint64_t data) {
+        return Entry{
+            .move = static_cast<PackedMove>(data & 0xFFFF),
+            .score = static_cast<std::int16_t>((data >> 16) & 0xFFFF),
+            .depth = static_cast<std::uint8_t>((data >> 32) & 0xFF),
+            .bound = static_cast<Bound>((data >> 40) & 0x3),
+        };
+    }
+
+    std::size_t m_size = 0;
+    std::unique_ptr<Slot[]> m_slots;
+    std::uint64_t m_generation = 0;
+};
@@ -0,0 +1,170 @@
+#include "watchdogengine.hpp"
+#include <algorithm>
+#include <exception>
+
+Watchdog &Watchdog::instance() {
+    static Watchdog watchdog;
+    return watchdog;
+}
+
+Watchdog::Watchdog() : m_thread([this]() { run(); }) {
+}
+
+Watchdog::~Watchdog() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_quit = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+std::uint64_t Watchdog::arm(Clock::time_point deadline, std::function<void()> on_expired) {
+    std::uint64_t id;
+    {
+        std::lock_guard lock(m_mutex);
+        id = m_next_id++;
+        m_timers.emplace(id, std::make_pair(deadline, std::move(on_expired)));
+    }
+    m_cv.notify_all();
+    return id;
+}
+
+void Watchdog::disarm(std::uint64_t id) {
+    std::unique_lock lock(m_mutex);
+    m_timers.erase(id);
+    // The callback may use the object that is disarming, so it has to finish first
+    m_cv.wait(lock, [this, id]() {
+        return m_running != id;
+    });
+}
+
+void Watchdog::run() {
+    std::unique_lock lock(m_mutex);
+    while (!m_quit) {
+        if (m_timers.empty()) {
+            m_cv.wait(lock);
+            continue;
+        }
+
+        const auto next = std::min_element(m_timers.begin(), m_timers.end(), [](const auto &a, const auto &b) {
+            return a.second.first < b.second.first;
+        });
+        if (Clock::now() < next->second.first) {
+            // Wakes up early when a timer is added or the watchdog quits
+            m_cv.wait_until(lock, next->second.first);
+            continue;
+        }
+
+        auto on_expired = std::move(next->second.second);
+        m_running = next->first;
+        m_timers.erase(next);
+        lock.unlock();
+        on_expired();
+        lock.lock();
+        m_running = std::nullopt;
+        m_cv.notify_all();
+    }
+}
+
+[[nodiscard]] WatchdogEngine::WatchdogEngine(std::shared_ptr<Engine> engine, const WatchdogSettings &settings)
+    : EngineProxy(std::move(engine)), m_settings(settings) {
+}
+
+void WatchdogEngine::guarded(const std::function<void()> &call) {
+    if (m_failure != Failure::None) {
+        return;
+    }
+    try {
+        call();
+    } catch (const std::exception &) {
+        m_failure = Failure::Crash;
+    }
+}
+
+auto WatchdogEngine::init() -> void {
+    guarded([this]() {
+        EngineProxy::init();
+    });
+}
+
+auto WatchdogEngine::position(const libataxx::Position &pos) -> void {
+    m_turn = pos.get_turn();
+    guarded([this, &pos]() {
+        EngineProxy::position(pos);
+    });
+}
+
+auto WatchdogEngine::set_option(const std::string &name, const std::string &value) -> void {
+    guarded([this, &name, &value]() {
+        EngineProxy::set_option(name, value);
+    });
+}
+
+auto WatchdogEngine::isready() -> void {
+    guarded([this]() {
+        EngineProxy::isready();
+    });
+}
+
+auto WatchdogEngine::newgame() -> void {
+    guarded([this]() {
+        EngineProxy::newgame();
+    });
+}
+
+auto WatchdogEngine::quit() -> void {
+    guarded([this]() {
+        EngineProxy::quit();
+    });
+}
+
+auto WatchdogEngine::stop() -> void {
+    guarded([this]() {
+        EngineProxy::stop();
+    });
+}
+
+auto WatchdogEngine::time_limit(const SearchSettings &settings) const -> std::chrono::milliseconds {
+    switch (settings.type) {
+        case SearchSettings::Type::Time:
+            return std::chrono::milliseconds(m_turn == libataxx::Side::Black ? settings.btime : settings.wtime);
+        case SearchSettings::Type::Movetime:
+            return std::chrono::milliseconds(settings.movetime);
+        default:
+            return m_settings.untimed_limit;
+    }
+}
+
+[[nodiscard]] auto WatchdogEngine::go(const SearchSettings &settings) -> std::string {
+    // There's no square a0, play() treats this as an illegal move of a forfeiting engine
+    constexpr auto forfeit_move = "a0a0";
+
+    if (m_failure != Failure::None) {
+        return forfeit_move;
+    }
+
+    const auto deadline = Watchdog::Clock::now() + time_limit(settings) + m_settings.grace;
+    const auto timer = Watchdog::instance().arm(deadline, [this]() {
+        auto expected = Failure::None;
+        if (m_failure.compare_exchange_strong(expected, Failure::Hang)) {
+            // Unblocks go(), which is waiting for the engine's answer
+            if (ProcessEngine *pe = process_engine(m_engine.get())) {
+                pe->kill();
+            } else {
+                m_engine->stop();
+            }
+        }
+    });
+
+    std::string move;
+    try {
+        move = EngineProxy::go(settings);
+    } catch (const std::exception &) {
+        auto expected = Failure::None;
+        m_failure.compare_exchange_strong(expected, Failure::Crash);
+    }
+    Watchdog::instance().disarm(timer);
+
+    return m_failure == Failure::None ? move : forfeit_move;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include "engineproxy.hpp"
+
+struct WatchdogSettings {
+    // Time an engine may take beyond its clock before it counts as hung
+    std::chrono::milliseconds grace{1000};
+    // Longest search for node and depth limits, which have no clock
+    std::chrono::milliseconds untimed_limit{60000};
+};
+
+// One thread that runs callbacks once their deadline passes, shared by all watched engines.
+class Watchdog {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    [[nodiscard]] static Watchdog &instance();
+
+    ~Watchdog();
+
+    [[nodiscard]] std::uint64_t arm(Clock::time_point deadline, std::function<void()> on_expired);
+    void disarm(std::uint64_t id);
+
+   private:
+    Watchdog();
+    void run();
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::map<std::uint64_t, std::pair<Clock::time_point, std::function<void()>>> m_timers;
+    std::uint64_t m_next_id = 0;
+    std::optional<std::uint64_t> m_running;
+    bool m_quit = false;
+    std::thread m_thread;
+};
+
+// Kills the engine's process if a search runs past its deadline and answers with an invalid move
+// instead, so play() ends the game rather than waiting forever. An engine that crashed answers the
+// same way. Either way the engine is dead for the rest of the game and calls aren't forwarded.
+class WatchdogEngine : public EngineProxy {
+   public:
+    enum class Failure
+    {
+        None,
+        Hang,
+        Crash,
+    };
+
+    [[nodiscard]] WatchdogEngine(std::shared_ptr<Engine> engine, const WatchdogSettings &settings);
+
+    auto init() -> void override;
+    auto position(const libataxx::Position &pos) -> void override;
+    auto set_option(const std::string &name, const std::string &value) -> void override;
+    [[nodiscard]] auto go(const SearchSettings &settings) -> std::string override;
+    auto isready() -> void override;
+    auto newgame() -> void override;
+    auto quit() -> void override;
+    auto stop() -> void override;
+
+    [[nodiscard]] auto failure() const -> Failure {
+        return m_failure;
+    }
+
+   private:
+    [[nodiscard]] auto time_limit(const SearchSettings &settings) const -> std::chrono::milliseconds;
+    // Runs call on the engine unless it's dead, a throwing call marks it as crashed
+    void guarded(const std::function<void()> &call);
+
+    WatchdogSettings m_settings;
+    libataxx::Side m_turn = libataxx::Side::Black;
+    std::atomic<Failure> m_failure = Failure::None;
+};
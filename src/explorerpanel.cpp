@@ -0,0 +1,194 @@
+#include "explorerpanel.hpp"
+#include <QCoreApplication>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QThread>
+#include <QVBoxLayout>
+#include <exception>
+#include <filesystem>
+#include "openings/openingbook.hpp"
+
+ExplorerPanel::ExplorerPanel(QWidget *parent) : QWidget(parent) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    QHBoxLayout *button_layout = new QHBoxLayout();
+    m_status = new QLabel("No explorer tree loaded", this);
+    m_table = new QTableWidget(0, 4, this);
+    m_load_button = new QPushButton("Load tree", this);
+    m_build_button = new QPushButton("Build from PGN", this);
+    m_book_button = new QPushButton("Make book", this);
+
+    m_table->setHorizontalHeaderLabels({"Move", "Games", "Score", "Eval"});
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    button_layout->addWidget(m_load_button);
+    button_layout->addWidget(m_build_button);
+    button_layout->addWidget(m_book_button);
+    layout->addLayout(button_layout);
+    layout->addWidget(m_status);
+    layout->addWidget(m_table);
+    layout->setContentsMargins(0, 0, 0, 0);
+    setLayout(layout);
+
+    connect(m_load_button, &QPushButton::clicked, [this]() {
+        const auto path = QFileDialog::getOpenFileName(
+            this, "Load explorer tree", QString::fromStdString(default_tree_path()), "Explorer tree (*.tree)");
+        if (!path.isEmpty()) {
+            load_tree(path);
+        }
+    });
+    connect(m_build_button, &QPushButton::clicked, this, &ExplorerPanel::build_tree);
+    connect(m_book_button, &QPushButton::clicked, this, &ExplorerPanel::make_book);
+    connect(m_table, &QTableWidget::cellDoubleClicked, [this](int row, int) {
+        if (row >= 0 && static_cast<std::size_t>(row) < m_moves.size()) {
+            emit move_selected(m_moves[row].move);
+        }
+    });
+
+    if (std::filesystem::exists(default_tree_path())) {
+        load_tree(QString::fromStdString(default_tree_path()));
+    }
+}
+
+std::string ExplorerPanel::default_games_path() {
+    return QCoreApplication::applicationDirPath().toStdString() + "/games.pgn";
+}
+
+std::string ExplorerPanel::default_tree_path() {
+    return QCoreApplication::applicationDirPath().toStdString() + "/explorer.tree";
+}
+
+void ExplorerPanel::set_position(QString fen) {
+    m_position = libataxx::Position(fen.toStdString());
+    update_table();
+}
+
+void ExplorerPanel::load_tree(QString path) {
+    try {
+        m_tree = std::make_unique<OpeningTree>(path.toStdString());
+        m_status->setText(QString("%1 positions").arg(m_tree->nodes().size()));
+    } catch (const std::exception &e) {
+        m_tree = nullptr;
+        m_status->setText("No explorer tree loaded");
+        QMessageBox::warning(this, "Failed to load explorer tree", e.what());
+    }
+    update_table();
+}
+
+void ExplorerPanel::build_tree() {
+    const auto pgn_paths = QFileDialog::getOpenFileNames(
+        this, "Build explorer tree from games", QString::fromStdString(default_games_path()), "PGN (*.pgn)");
+    if (pgn_paths.isEmpty()) {
+        return;
+    }
+
+    std::vector<std::string> paths;
+    for (const auto &path : pgn_paths) {
+        paths.push_back(path.toStdString());
+    }
+
+    // The tree is mapped while being rebuilt, so release it first
+    m_tree = nullptr;
+    m_status->setText("No explorer tree loaded");
+    update_table();
+    run_job(
+        "Building explorer tree...",
+        [paths]() {
+            OpeningTree::build(paths, default_tree_path());
+        },
+        [this]() {
+            load_tree(QString::fromStdString(default_tree_path()));
+        });
+}
+
+void ExplorerPanel::make_book() {
+    const auto book_path = QFileDialog::getSaveFileName(this,
+                                                        "Save opening book",
+                                                        QCoreApplication::applicationDirPath() + "/book.bin",
+                                                        "Opening book (*.bin)")
+                               .toStdString();
+    if (book_path.empty()) {
+        return;
+    }
+
+    const auto status = m_status->text();
+    if (m_tree) {
+        run_job(
+            "Making opening book...",
+            [this, book_path]() {
+                OpeningBook::build_from_tree(*m_tree, book_path);
+            },
+            [this, status]() {
+                m_status->setText(status);
+            });
+        return;
+    }
+
+    const auto pgn_paths = QFileDialog::getOpenFileNames(
+        this, "Make opening book from games", QString::fromStdString(default_games_path()), "PGN (*.pgn)");
+    if (pgn_paths.isEmpty()) {
+        return;
+    }
+    std::vector<std::string> paths;
+    for (const auto &path : pgn_paths) {
+        paths.push_back(path.toStdString());
+    }
+    run_job(
+        "Making opening book...",
+        [paths, book_path]() {
+            OpeningBook::build_from_pgn(paths, book_path);
+        },
+        [this, status]() {
+            m_status->setText(status);
+        });
+}
+
+void ExplorerPanel::run_job(QString status, std::function<void()> job, std::function<void()> on_success) {
+    m_load_button->setEnabled(false);
+    m_build_button->setEnabled(false);
+    m_book_button->setEnabled(false);
+    const auto previous_status = m_status->text();
+    m_status->setText(status);
+
+    auto error = std::make_shared<std::string>();
+    QThread *thread = QThread::create([job, error]() {
+        try {
+            job();
+        } catch (const std::exception &e) {
+            *error = e.what();
+        }
+    });
+    connect(thread, &QThread::finished, this, [this, thread, error, on_success, previous_status]() {
+        thread->deleteLater();
+        m_load_button->setEnabled(true);
+        m_build_button->setEnabled(true);
+        m_book_button->setEnabled(true);
+        if (!error->empty()) {
+            m_status->setText(previous_status);
+            QMessageBox::warning(this, "Explorer", QString::fromStdString(*error));
+            return;
+        }
+        on_success();
+    });
+    thread->start();
+}
+
+void ExplorerPanel::update_table() {
+    m_moves = m_tree ? m_tree->moves(m_position) : std::vector<ExplorerMove>{};
+
+    m_table->setRowCount(static_cast<int>(m_moves.size()));
+    for (std::size_t i = 0; i < m_moves.size(); ++i) {
+        const auto &move = m_moves[i];
+        const int row = static_cast<int>(i);
+        m_table->setItem(row, 0, new QTableWidgetItem(QString::fromStdString(static_cast<std::string>(move.move))));
+        m_table->setItem(row, 1, new QTableWidgetItem(QString::number(move.games)));
+        m_table->setItem(row, 2, new QTableWidgetItem(QString::number(move.score * 100.0, 'f', 1) + "%"));
+        m_table->setItem(row,
+                         3,
+                         new QTableWidgetItem(move.eval.has_value() ? QString::number(move.eval.value(), 'f', 2) : "-"));
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QWidget>
+#include <functional>
+#include <libataxx/position.hpp>
+#include <memory>
+#include "openings/openingtree.hpp"
+
+// Lists the moves of the current position with statistics from an OpeningTree file.
+class ExplorerPanel : public QWidget {
+    Q_OBJECT
+
+   public:
+    ExplorerPanel(QWidget *parent = nullptr);
+
+    static std::string default_games_path();
+    static std::string default_tree_path();
+
+   public slots:
+    void set_position(QString fen);
+    void load_tree(QString path);
+
+   signals:
+    void move_selected(libataxx::Move move);
+
+   private slots:
+    void build_tree();
+    void make_book();
+
+   private:
+    void update_table();
+    // Runs job on a separate thread with the buttons disabled, then on_success on the GUI thread
+    void run_job(QString status, std::function<void()> job, std::function<void()> on_success);
+
+    QLabel *m_status{nullptr};
+    QTableWidget *m_table{nullptr};
+    QPushButton *m_load_button{nullptr};
+    QPushButton *m_build_button{nullptr};
+    QPushButton *m_book_button{nullptr};
+    std::unique_ptr<OpeningTree> m_tree;
+    libataxx::Position m_position;
+    std::vector<ExplorerMove> m_moves;
+};
@@ -0,0 +1,203 @@
+#include "gamespanel.hpp"
+#include <QFontMetrics>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <algorithm>
+#include <bit>
+#include "boardview/images.hpp"
+#include "tracer.hpp"
+
+namespace {
+
+constexpr int board_files = 7;
+constexpr int min_square_size = 14;
+constexpr int max_square_size = 28;
+constexpr int spacing = 8;
+
+}  // namespace
+
+GamesPanel::GamesPanel(QWidget *parent) : QAbstractScrollArea(parent) {
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    viewport()->setAttribute(Qt::WA_OpaquePaintEvent);
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(refresh_ms);
+    connect(&m_timer, &QTimer::timeout, this, &GamesPanel::refresh);
+    update_layout();
+}
+
+void GamesPanel::clear() {
+    m_boards.clear();
+    update_layout();
+    viewport()->update();
+}
+
+void GamesPanel::set_game(int slot, const QString &title, const libataxx::Position &pos) {
+    if (slot >= static_cast<int>(m_boards.size())) {
+        m_boards.resize(slot + 1);
+        update_layout();
+    }
+    auto &board = m_boards[slot];
+    board.title = title;
+    board.status.clear();
+    board.position = pos;
+    board.bits = board_bits(pos);
+    board.plies = 0;
+    mark_dirty(slot);
+}
+
+void GamesPanel::on_new_move(int slot, const libataxx::Move &move) {
+    if (slot >= static_cast<int>(m_boards.size())) {
+        return;
+    }
+    auto &board = m_boards[slot];
+    board.position.makemove(move);
+    board.bits = board_bits(board.position);
+    board.plies++;
+    mark_dirty(slot);
+}
+
+void GamesPanel::set_result(int slot, const QString &result) {
+    if (slot >= static_cast<int>(m_boards.size())) {
+        return;
+    }
+    m_boards[slot].status = result;
+    mark_dirty(slot);
+}
+
+void GamesPanel::reload() {
+    m_board_pixmap = QPixmap();
+    viewport()->update();
+}
+
+void GamesPanel::set_suspended(bool suspended) {
+    m_suspended = suspended;
+    if (suspended) {
+        m_timer.stop();
+        return;
+    }
+    for (auto &board : m_boards) {
+        board.dirty = false;
+    }
+    viewport()->update();
+}
+
+void GamesPanel::mark_dirty(int slot) {
+    m_boards[slot].dirty = true;
+    if (!m_suspended && !m_timer.isActive()) {
+        m_timer.start();
+    }
+}
+
+void GamesPanel::refresh() {
+    // Hidden boards are painted in full when they are shown again
+    if (!isVisible()) {
+        return;
+    }
+    const auto visible = viewport()->rect();
+    for (int slot = 0; slot < static_cast<int>(m_boards.size()); ++slot) {
+        auto &board = m_boards[slot];
+        if (!board.dirty) {
+            continue;
+        }
+        board.dirty = false;
+        const auto rect = board_rect(slot);
+        if (rect.intersects(visible)) {
+            viewport()->update(rect);
+        }
+    }
+}
+
+void GamesPanel::update_layout() {
+    // As many boards side by side as fit with at least the smallest square size
+    const int width = std::max(viewport()->width() - spacing, 1);
+    const int min_cell = board_files * min_square_size + spacing;
+    m_columns = std::max(1, width / min_cell);
+    const int square_size =
+        std::clamp((width / m_columns - spacing) / board_files, min_square_size, max_square_size);
+    if (square_size != m_square_size) {
+        m_square_size = square_size;
+        m_board_pixmap = QPixmap();
+    }
+    m_title_height = QFontMetrics(font()).height() * 2;
+
+    const int rows = (static_cast<int>(m_boards.size()) + m_columns - 1) / m_columns;
+    const int content_height = rows * (board_files * m_square_size + m_title_height + spacing) + spacing;
+    verticalScrollBar()->setPageStep(viewport()->height());
+    verticalScrollBar()->setSingleStep(m_square_size);
+    verticalScrollBar()->setRange(0, std::max(0, content_height - viewport()->height()));
+}
+
+void GamesPanel::update_pixmaps() {
+    const int board_size = board_files * m_square_size;
+    m_board_pixmap =
+        BoardImage::board_image().scaled(board_size, board_size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    for (int i = 0; i < 3; ++i) {
+        m_piece_pixmaps[i] = PieceImages::piece_images(static_cast<libataxx::Piece>(i))
+                                 .scaled(m_square_size, m_square_size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+}
+
+QRect GamesPanel::board_rect(int slot) const {
+    const int board_size = board_files * m_square_size;
+    const int cell_width = board_size + spacing;
+    const int cell_height = board_size + m_title_height + spacing;
+    const int x = spacing + (slot % m_columns) * cell_width;
+    const int y = spacing + (slot / m_columns) * cell_height - verticalScrollBar()->value();
+    return QRect(x, y, board_size, board_size + m_title_height);
+}
+
+void GamesPanel::paint_board(QPainter &painter, const Board &board, const QRect &rect) const {
+    const auto text_rect = QRect(rect.left(), rect.top(), rect.width(), m_title_height);
+    const auto status = board.status.isEmpty() ? QString("Ply %1").arg(board.plies) : board.status;
+    painter.drawText(text_rect, Qt::AlignLeft | Qt::AlignTop | Qt::TextSingleLine, board.title);
+    painter.drawText(text_rect, Qt::AlignLeft | Qt::AlignBottom | Qt::TextSingleLine, status);
+
+    const auto origin = QPoint(rect.left(), rect.top() + m_title_height);
+    painter.drawPixmap(origin, m_board_pixmap);
+    const std::array<std::uint64_t, 3> pieces = {board.bits.black, board.bits.white, board.bits.gaps};
+    for (int i = 0; i < 3; ++i) {
+        for (auto bb = pieces[i]; bb; bb &= bb - 1) {
+            // Square index rank * 7 + file with rank 0 at the bottom
+            const int square = std::countr_zero(bb);
+            const int file = square % board_files;
+            const int rank = square / board_files;
+            painter.drawPixmap(origin + QPoint(file * m_square_size, (board_files - 1 - rank) * m_square_size),
+                               m_piece_pixmaps[i]);
+        }
+    }
+}
+
+void GamesPanel::paintEvent(QPaintEvent *event) {
+    const TraceSpan span("paint games", "gui");
+    if (m_board_pixmap.isNull()) {
+        update_pixmaps();
+    }
+
+    QPainter painter(viewport());
+    painter.fillRect(event->rect(), palette().window());
+    painter.setPen(palette().text().color());
+    for (int slot = 0; slot < static_cast<int>(m_boards.size()); ++slot) {
+        const auto rect = board_rect(slot);
+        if (rect.intersects(event->rect())) {
+            paint_board(painter, m_boards[slot], rect);
+        }
+    }
+}
+
+void GamesPanel::resizeEvent(QResizeEvent *event) {
+    QAbstractScrollArea::resizeEvent(event);
+    update_layout();
+}
+
+void GamesPanel::showEvent(QShowEvent *event) {
+    QAbstractScrollArea::showEvent(event);
+    for (auto &board : m_boards) {
+        board.dirty = false;
+    }
+    viewport()->update();
+}
+
+void GamesPanel::scrollContentsBy(int, int) {
+    viewport()->update();
+}
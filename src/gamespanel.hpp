@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QAbstractScrollArea>
+#include <QPixmap>
+#include <QString>
+#include <QTimer>
+#include <array>
+#include <libataxx/position.hpp>
+#include <vector>
+#include "boardsymmetry.hpp"
+
+// Small live boards of all games a match is playing, one per slot.
+// Everything is painted by one painter from the boards' bitboards with piece pixmaps scaled once,
+// there is no scene per game. Moves only mark a board, a timer repaints the marked boards that
+// are on screen at most refresh_ms apart.
+class GamesPanel : public QAbstractScrollArea {
+    Q_OBJECT
+
+   public:
+    GamesPanel(QWidget *parent = nullptr);
+
+    void clear();
+    void set_game(int slot, const QString &title, const libataxx::Position &pos);
+    void on_new_move(int slot, const libataxx::Move &move);
+    void set_result(int slot, const QString &result);
+    // Piece or board theme changed
+    void reload();
+    // While suspended moves are only recorded, resuming repaints everything once
+    void set_suspended(bool suspended);
+
+   protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+   private:
+    struct Board {
+        QString title;
+        QString status;
+        libataxx::Position position;
+        BoardBits bits;
+        int plies = 0;
+        bool dirty = false;
+    };
+
+    static constexpr int refresh_ms = 100;
+
+    void refresh();
+    void update_layout();
+    void update_pixmaps();
+    void mark_dirty(int slot);
+    [[nodiscard]] QRect board_rect(int slot) const;
+    void paint_board(QPainter &painter, const Board &board, const QRect &rect) const;
+
+    std::vector<Board> m_boards;
+    QTimer m_timer;
+    bool m_suspended = false;
+    int m_columns = 1;
+    int m_square_size = 0;
+    int m_title_height = 0;
+    // Board and pieces scaled to m_square_size, built on the next paint when null
+    QPixmap m_board_pixmap;
+    std::array<QPixmap, 3> m_piece_pixmaps;
+};
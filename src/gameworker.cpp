@@ -1,37 +1,158 @@
 #include "gameworker.hpp"
+#include <QCoreApplication>
+#include <exception>
+#include <thread>
+#include "engines/watchdogengine.hpp"
+#include "metrics/metrics.hpp"
+#include "tracer.hpp"
 
 GameWorker::GameWorker(const AdjudicationSettings &adjudication,
+                       const AdjudicationRules &rules,
                        const GameSettings &game,
                        std::shared_ptr<Engine> engine1,
-                       std::shared_ptr<Engine> engine2)
-    : m_adjudication(adjudication), m_game(game), m_engine1(engine1), m_engine2(engine2) {
+                       std::shared_ptr<Engine> engine2,
+                       std::chrono::milliseconds move_delay)
+    : m_adjudication(adjudication),
+      m_rules(rules),
+      m_game(game),
+      m_move_delay(move_delay),
+      m_engine1(engine1),
+      m_engine2(engine2) {
+}
+
+GameWorker::GameWorker(const AdjudicationSettings &adjudication,
+                       const AdjudicationRules &rules,
+                       const GameSettings &game,
+                       EngineFactory engine_factory,
+                       std::chrono::milliseconds move_delay)
+    : m_adjudication(adjudication),
+      m_rules(rules),
+      m_game(game),
+      m_engine_factory(engine_factory),
+      m_move_delay(move_delay) {
 }
 
 void GameWorker::start_game() {
-    m_stop_flag = false;
+    // Stopped while the start was queued, there's nothing to clean up yet
+    if (m_stop_flag) {
+        return;
+    }
+
+    std::shared_ptr<Engine> engine1, engine2;
+    try {
+        if (m_engine_factory) {
+            engine1 = m_engine_factory(m_game.engine1);
+            engine2 = m_engine_factory(m_game.engine2);
+            std::lock_guard lock(m_engine_mutex);
+            m_engine1 = engine1;
+            m_engine2 = engine2;
+        } else {
+            std::lock_guard lock(m_engine_mutex);
+            engine1 = m_engine1;
+            engine2 = m_engine2;
+        }
+    } catch (const std::exception &e) {
+        emit failed(QString("Failed to create engine: ") + e.what());
+        return;
+    }
+    // stopGame() might have run before the engines existed
+    if (m_stop_flag) {
+        stopGame();
+        return;
+    }
 
     emit update_time_control(m_game.engine1.tc, m_game.engine2.tc, libataxx::Position(m_game.fen).get_turn());
-    const auto result = play(
-        m_adjudication, m_game, m_engine1, m_engine2, [this](GameThingy info, SearchSettings tc1, SearchSettings tc2) {
-            Q_ASSERT(info.history.size() > 0);
-            if (m_stop_flag) {
-                return false;
+    Adjudicator adjudicator(m_rules, engine1.get(), engine2.get());
+    std::optional<GameOutcome> adjudicated;
+    try {
+        auto result = play(m_adjudication,
+                           m_game,
+                           engine1,
+                           engine2,
+                           [this, &adjudicator, &adjudicated](GameThingy info, SearchSettings tc1, SearchSettings tc2) {
+                               Q_ASSERT(info.history.size() > 0);
+                               if (m_stop_flag) {
+                                   return false;
+                               }
+                               Metrics::instance().add(Metrics::Counter::Moves);
+                               emit new_move(info);
+                               if (Tracer::instance().enabled()) {
+                                   // Queued behind the move, so it ends once the GUI thread has handled it
+                                   QMetaObject::invokeMethod(
+                                       QCoreApplication::instance(),
+                                       [sent = Tracer::Clock::now()]() {
+                                           const auto delivered = Tracer::Clock::now();
+                                           Tracer::instance().complete("new_move delivery", "signal", sent, delivered);
+                                       },
+                                       Qt::QueuedConnection);
+                               }
+                               emit update_time_control(tc1, tc2, info.endpos.get_turn());
+                               adjudicated = adjudicator.adjudicate(info);
+                               if (adjudicated.has_value()) {
+                                   return false;
+                               }
+                               std::this_thread::sleep_for(m_move_delay);
+                               return true;
+                           });
+        if (adjudicated.has_value()) {
+            result.result = adjudicated.value();
+        }
+        report_engine_failures(engine1, engine2);
+        emit finished_game(result);
+    } catch (const std::exception &e) {
+        report_engine_failures(engine1, engine2);
+        emit failed(QString("Game aborted: ") + e.what());
+    }
+}
+
+void GameWorker::report_engine_failures(const std::shared_ptr<Engine> &engine1, const std::shared_ptr<Engine> &engine2) {
+    int id = 1;
+    for (const auto &engine : {engine1, engine2}) {
+        if (const auto *watchdog = find_engine<WatchdogEngine>(engine.get())) {
+            if (watchdog->failure() != WatchdogEngine::Failure::None) {
+                emit engine_failed(id, watchdog->failure() == WatchdogEngine::Failure::Crash);
             }
-            emit new_move(info);
-            emit update_time_control(tc1, tc2, info.endpos.get_turn());
-            std::this_thread::sleep_for(std::chrono::milliseconds(300));
-            return true;
-        });
-    emit finished_game(result);
+        }
+        id++;
+    }
 }
 
-void GameWorker::stopGame() {
+std::vector<std::shared_ptr<Engine>> GameWorker::request_stop() {
     m_stop_flag = true;
-    for (auto engine : std::vector{m_engine1, m_engine2}) {
-        engine->quit();
-        if (ProcessEngine *pe = dynamic_cast<ProcessEngine *>(engine.get())) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            pe->kill();
+    std::lock_guard lock(m_engine_mutex);
+    std::vector<std::shared_ptr<Engine>> engines;
+    for (const auto &engine : {m_engine1, m_engine2}) {
+        if (engine) {
+            engine->quit();
+            engines.push_back(engine);
+        }
+    }
+    return engines;
+}
+
+void GameWorker::stop_games(const std::vector<GameWorker *> &workers) {
+    // The engines are kept alive until their processes are killed
+    std::vector<std::shared_ptr<Engine>> engines;
+    std::vector<ProcessEngine *> processes;
+    for (auto *worker : workers) {
+        for (auto &engine : worker->request_stop()) {
+            if (ProcessEngine *pe = process_engine(engine.get())) {
+                processes.push_back(pe);
+            }
+            engines.push_back(std::move(engine));
         }
     }
-}
\ No newline at end of file
+
+    if (processes.empty()) {
+        return;
+    }
+    // One wait for all of them, however many games are stopped
+    std::this_thread::sleep_for(engine_quit_time);
+    for (auto *pe : processes) {
+        pe->kill();
+    }
+}
+
+void GameWorker::stopGame() {
+    stop_games({this});
+}
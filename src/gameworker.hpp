@@ -4,15 +4,40 @@
 #include <../core/engine/process.hpp>
 #include <../core/play.hpp>
 #include <QThread>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "adjudication/adjudicator.hpp"
 
 class GameWorker : public QObject {
     Q_OBJECT
 
    public:
+    using EngineFactory = std::function<std::shared_ptr<Engine>(const EngineSettings &)>;
+
+    // Pause after every move so the board animation can keep up
+    static constexpr std::chrono::milliseconds gui_move_delay{300};
+    // Time the engines get to quit before their processes are killed
+    static constexpr std::chrono::milliseconds engine_quit_time{100};
+
     GameWorker(const AdjudicationSettings &adjudication,
+               const AdjudicationRules &rules,
                const GameSettings &game,
                std::shared_ptr<Engine> engine1,
-               std::shared_ptr<Engine> engine2);
+               std::shared_ptr<Engine> engine2,
+               std::chrono::milliseconds move_delay = gui_move_delay);
+
+    // The engines are created on the worker's thread when the game starts
+    GameWorker(const AdjudicationSettings &adjudication,
+               const AdjudicationRules &rules,
+               const GameSettings &game,
+               EngineFactory engine_factory,
+               std::chrono::milliseconds move_delay);
+
+    // Stops the games of all workers together: every engine is told to quit, then all engine processes
+    // are killed once engine_quit_time has passed. Thread-safe.
+    static void stop_games(const std::vector<GameWorker *> &workers);
 
    public slots:
     void start_game();
@@ -22,11 +47,25 @@ class GameWorker : public QObject {
     void finished_game(GameThingy result);
     void new_move(GameThingy info);
     void update_time_control(SearchSettings tc1, SearchSettings tc2, libataxx::Side side_to_move);
+    // The game couldn't be played to its end, e.g. because an engine failed to start
+    void failed(QString reason);
+    // Engine 1 or 2 hung or crashed and lost the game, sent before finished_game or failed
+    void engine_failed(int engine, bool crashed);
 
    private:
+    // Sets the stop flag and tells the engines to quit, returns the engines
+    [[nodiscard]] std::vector<std::shared_ptr<Engine>> request_stop();
+    void report_engine_failures(const std::shared_ptr<Engine> &engine1, const std::shared_ptr<Engine> &engine2);
+
     AdjudicationSettings m_adjudication;
+    AdjudicationRules m_rules;
     GameSettings m_game;
+    EngineFactory m_engine_factory;
+    std::chrono::milliseconds m_move_delay;
+    std::mutex m_engine_mutex;
     std::shared_ptr<Engine> m_engine1;
     std::shared_ptr<Engine> m_engine2;
-    std::atomic_bool m_stop_flag;
+    // Only cleared on construction, a worker plays one game and a stopGame() that comes before the
+    // queued start_game() has to stay set
+    std::atomic_bool m_stop_flag = false;
 };
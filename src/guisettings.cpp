@@ -1,8 +1,180 @@
 #include "guisettings.hpp"
+#include <QCoreApplication>
+#include <QDir>
+#include <filesystem>
 #include <fstream>
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <stdexcept>
 
+namespace {
+
+std::optional<BookSettings> parse_book(const nlohmann::ordered_json &json) {
+    if (json.is_boolean() && !json.get<bool>()) {
+        return std::nullopt;
+    }
+    BookSettings book;
+    for (const auto &[key, val] : json.items()) {
+        if (key == "file") {
+            book.file = val.get<std::string>();
+        } else if (key == "depth") {
+            book.depth = val.get<int>();
+        }
+    }
+    if (book.file.empty()) {
+        throw std::runtime_error("Opening book settings need a \"file\"");
+    }
+    return book;
+}
+
+ScoreRule parse_score_rule(const nlohmann::ordered_json &json) {
+    ScoreRule rule;
+    for (const auto &[key, val] : json.items()) {
+        if (key == "score") {
+            rule.score = val.get<int>();
+        } else if (key == "moves") {
+            rule.moves = val.get<int>();
+        }
+    }
+    return rule;
+}
+
+AdjudicationRules parse_adjudication(const nlohmann::ordered_json &json) {
+    AdjudicationRules rules;
+    for (const auto &[key, val] : json.items()) {
+        if (key == "resign") {
+            rules.resign = parse_score_rule(val);
+        } else if (key == "draw") {
+            rules.draw = parse_score_rule(val);
+            if (val.contains("after")) {
+                rules.draw_after = val["after"].get<int>();
+            }
+        } else if (key == "material") {
+            rules.material = val.get<int>();
+        } else if (key == "maxplies") {
+            rules.max_plies = val.get<int>();
+        } else if (key == "endgame") {
+            for (const auto &[k, v] : val.items()) {
+                if (k == "empties") {
+                    rules.endgame.max_empties = v.get<int>();
+                } else if (k == "nodes") {
+                    rules.endgame.nodes = v.get<std::uint64_t>();
+                } else if (k == "threads") {
+                    rules.endgame.threads = v.get<int>();
+                } else if (k == "hash") {
+                    rules.endgame.hash_mb = v.get<std::size_t>();
+                }
+            }
+        }
+    }
+    return rules;
+}
+
+MatchSettings parse_match(const nlohmann::ordered_json &json) {
+    MatchSettings match;
+    for (const auto &[key, val] : json.items()) {
+        if (key == "games") {
+            match.games = val.get<int>();
+        } else if (key == "engines") {
+            match.engines = val.get<std::vector<std::string>>();
+        } else if (key == "format") {
+            const auto format = val.get<std::string>();
+            if (format == "roundrobin") {
+                match.format = MatchSettings::Format::RoundRobin;
+            } else if (format == "gauntlet") {
+                match.format = MatchSettings::Format::Gauntlet;
+            } else {
+                throw std::runtime_error("Unknown match format \"" + format + "\"");
+            }
+        } else if (key == "concurrency") {
+            match.concurrency = val.get<int>();
+        } else if (key == "affinity") {
+            match.pin_cpus = val.get<bool>();
+        } else if (key == "resources") {
+            for (const auto &[k, v] : val.items()) {
+                if (k == "auto") {
+                    match.resources.automatic = v.get<bool>();
+                } else if (k == "cores") {
+                    match.resources.cores = v.get<unsigned>();
+                } else if (k == "memory") {
+                    match.resources.memory_mb = v.get<std::uint64_t>();
+                } else if (k == "reserve") {
+                    match.resources.reserve_mb = v.get<std::uint64_t>();
+                }
+            }
+        } else if (key == "pgnout") {
+            match.pgn_out = val.get<std::string>();
+        } else if (key == "journal") {
+            match.journal = val.get<std::string>();
+        } else if (key == "trace") {
+            match.trace = val.get<std::string>();
+        } else if (key == "ratingsout") {
+            match.ratings_out = val.get<std::string>();
+        } else if (key == "openings") {
+            OpeningSuiteSettings openings;
+            for (const auto &[k, v] : val.items()) {
+                if (k == "file") {
+                    openings.file = v.get<std::string>();
+                } else if (k == "order") {
+                    const auto order = v.get<std::string>();
+                    if (order == "random") {
+                        openings.order = OpeningSuiteSettings::Order::Random;
+                    } else if (order == "sequential") {
+                        openings.order = OpeningSuiteSettings::Order::Sequential;
+                    } else {
+                        throw std::runtime_error("Unknown opening order \"" + order + "\"");
+                    }
+                } else if (k == "seed") {
+                    openings.seed = v.get<std::uint64_t>();
+                } else if (k == "start") {
+                    openings.start = v.get<std::uint64_t>();
+                }
+            }
+            if (openings.file.empty()) {
+                throw std::runtime_error("Opening suite settings need a \"file\"");
+            }
+            match.openings = openings;
+        } else if (key == "sprt") {
+            SprtSettings sprt;
+            for (const auto &[k, v] : val.items()) {
+                if (k == "elo0") {
+                    sprt.elo0 = v.get<double>();
+                } else if (k == "elo1") {
+                    sprt.elo1 = v.get<double>();
+                } else if (k == "alpha") {
+                    sprt.alpha = v.get<double>();
+                } else if (k == "beta") {
+                    sprt.beta = v.get<double>();
+                }
+            }
+            if (sprt.alpha <= 0.0 || sprt.alpha >= 1.0 || sprt.beta <= 0.0 || sprt.beta >= 1.0) {
+                throw std::runtime_error("SPRT alpha and beta have to be between 0 and 1");
+            }
+            if (sprt.elo0 >= sprt.elo1) {
+                throw std::runtime_error("SPRT elo0 has to be less than elo1");
+            }
+            match.sprt = sprt;
+        } else if (key == "adjudication") {
+            match.adjudication = parse_adjudication(val);
+        }
+    }
+    // The engines may come after the sprt in the file
+    if (match.sprt.has_value() && match.engines.size() > 2) {
+        throw std::runtime_error("An SPRT needs a match between two engines");
+    }
+    return match;
+}
+
+}  // namespace
+
+std::string settings_file_path() {
+    std::string altSettingPath = QDir::homePath().toStdString() + "/.AtaxxGUI/settings.json";
+    if (std::filesystem::exists(altSettingPath)) {
+        return altSettingPath;
+    }
+    return QCoreApplication::applicationDirPath().toStdString() + "/settings.json";
+}
+
 GuiSettings::GuiSettings(const std::string &path) {
     nlohmann::ordered_json json;
 
@@ -27,6 +199,7 @@ GuiSettings::GuiSettings(const std::string &path) {
     this->tc = SearchSettings::as_time(30000, 30000, 1000, 1000);
 
     std::vector<std::pair<std::string, std::string>> engine_options;
+    std::optional<BookSettings> default_book;
 
     for (const auto &[a, b] : json.items()) {
         if (a == "timecontrol") {
@@ -54,6 +227,28 @@ GuiSettings::GuiSettings(const std::string &path) {
             for (const auto &[key, val] : b.items()) {
                 engine_options.emplace_back(key, val);
             }
+        } else if (a == "book") {
+            default_book = parse_book(b);
+        } else if (a == "match") {
+            this->match = parse_match(b);
+        } else if (a == "adjudication") {
+            this->adjudication = parse_adjudication(b);
+        } else if (a == "metrics") {
+            for (const auto &[key, val] : b.items()) {
+                if (key == "port") {
+                    this->metrics.port = val.get<std::uint16_t>();
+                } else if (key == "address") {
+                    this->metrics.address = val.get<std::string>();
+                }
+            }
+        } else if (a == "watchdog") {
+            for (const auto &[key, val] : b.items()) {
+                if (key == "grace") {
+                    this->watchdog.grace = std::chrono::milliseconds(val.get<int>());
+                } else if (key == "untimed") {
+                    this->watchdog.untimed_limit = std::chrono::milliseconds(val.get<int>());
+                }
+            }
         }
     }
 
@@ -63,6 +258,7 @@ GuiSettings::GuiSettings(const std::string &path) {
         details.id = this->engines.size();
         details.options = engine_options;
         details.tc = this->tc;
+        auto book = default_book;
 
         for (const auto &[a, b] : engine.items()) {
             if (a == "path") {
@@ -82,6 +278,8 @@ GuiSettings::GuiSettings(const std::string &path) {
                 details.builtin = b.get<std::string>();
             } else if (a == "arguments") {
                 details.arguments = b.get<std::string>();
+            } else if (a == "book") {
+                book = parse_book(b);
             } else if (a == "options") {
                 for (const auto &[key, val] : b.items()) {
                     const auto iter =
@@ -125,6 +323,10 @@ GuiSettings::GuiSettings(const std::string &path) {
             details.name = details.path;
         }
 
+        if (book.has_value()) {
+            this->books[details.name] = book.value();
+        }
+
         this->engines.emplace_back(details);
     }
 
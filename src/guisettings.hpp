@@ -1,11 +1,30 @@
 #pragma once
 
 #include <../core/engine/settings.hpp>
+#include <map>
 #include <vector>
+#include "engines/watchdogengine.hpp"
+#include "match/matchsettings.hpp"
+#include "metrics/metricsserver.hpp"
+
+struct BookSettings {
+    std::string file;
+    // Maximum number of book plies, 0 to stay in book as long as possible
+    int depth = 0;
+};
+
+// The user's settings file if there is one, otherwise the one next to the executable
+[[nodiscard]] std::string settings_file_path();
 
 struct GuiSettings {
     GuiSettings(const std::string &path);
 
     std::vector<EngineSettings> engines;
     SearchSettings tc;
+    // Opening book by engine name, engines without an entry don't use one
+    std::map<std::string, BookSettings> books;
+    MatchSettings match;
+    WatchdogSettings watchdog;
+    AdjudicationRules adjudication;
+    MetricsSettings metrics;
 };
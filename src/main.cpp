@@ -1,7 +1,13 @@
 #include <QApplication>
 #include "mainwindow.hpp"
+#include "tools/tools.hpp"
 
 int main(int argc, char *argv[]) {
+    if (argc > 1 && is_tool(argv[1])) {
+        QCoreApplication app(argc, argv);
+        return run_tool(app.arguments().mid(1));
+    }
+
     QApplication app(argc, argv);
 
     MainWindow window;
@@ -4,10 +4,10 @@
 #include <qlabel.h>
 #include <qmessagebox.h>
 #include <qpushbutton.h>
-#include <../core/engine/create.hpp>
 #include <../core/pgn.hpp>
 #include <QApplication>
 #include <QDir>
+#include <QEvent>
 #include <QGridLayout>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -30,9 +30,17 @@
 #include "boardview/boardview.hpp"
 #include "boardview/images.hpp"
 #include "engine/settings.hpp"
+#include "engines/bookengine.hpp"
+#include "engines/enginefactory.hpp"
+#include "engines/scoreengine.hpp"
+#include "engines/traceengine.hpp"
+#include "engines/watchdogengine.hpp"
 #include "guisettings.hpp"
 #include "humanengine.hpp"
+#include "match/gameresult.hpp"
+#include "startpositions.hpp"
 #include "texteditor.hpp"
+#include "tracer.hpp"
 
 // #include "boardview/boardscene.hpp"
 
@@ -61,28 +69,33 @@ auto get_recv_send_callbacks(const std::string &engine_name) {
                      }};
 }
 
-std::string getSettingsFilePath() {
-    std::string altSettingPath = QDir::homePath().toStdString() + "/.AtaxxGUI/settings.json";
-    if (std::filesystem::exists(altSettingPath)) {
-        return altSettingPath;
+std::shared_ptr<Engine> make_gui_engine(const EngineSettings &settings,
+                                        const std::map<std::string, BookSettings> &books,
+                                        const WatchdogSettings &watchdog) {
+    const auto [send, log_recv] = get_recv_send_callbacks(settings.name);
+    // Scores for adjudication come from the info lines
+    auto scores = std::make_shared<ScoreTracker>();
+    const auto recv = [log_recv, scores](const std::string &line) {
+        log_recv(line);
+        scores->on_line(line);
+    };
+
+    std::shared_ptr<Engine> engine;
+    {
+        const TraceSpan span("spawn", "engine", settings.name);
+        engine = create_engine(settings, send, recv);
     }
-    return QCoreApplication::applicationDirPath().toStdString() + "/settings.json";
-}
+    if (Tracer::instance().enabled()) {
+        engine = std::make_shared<TraceEngine>(engine, settings.name);
+    }
+    engine = std::make_shared<WatchdogEngine>(engine, watchdog);
 
-const std::vector<std::string> start_positions = {"x5o/7/2-1-2/7/2-1-2/7/o5x x 0 1",
-                                                  "x5o/7/7/7/7/7/o5x x 0 1",
-                                                  "x5o/1-3-1/2-1-2/7/2-1-2/1-3-1/o5x x 0 1",
-                                                  "x5o/7/3-3/2-1-2/3-3/7/o5x x 0 1",
-                                                  "x5o/3-3/3-3/1--1--1/3-3/3-3/o5x x 0 1",
-                                                  "x2-2o/7/7/-5-/7/7/o2-2x x 0 1",
-                                                  "x2-2o/3-3/3-3/---1---/3-3/3-3/o2-2x x 0 1",
-                                                  "x5o/2-1-2/1-3-1/7/1-3-1/2-1-2/o5x x 0 1",
-                                                  "x1-1-1o/7/-5-/7/-5-/7/o1-1-1x x 0 1",
-                                                  "x2-2o/3-3/2---2/7/2---2/3-3/o2-2x x 0 1",
-                                                  "x2-2o/3-3/7/--3--/7/3-3/o2-2x x 0 1",
-                                                  "x1-1-1o/2-1-2/2-1-2/7/2-1-2/2-1-2/o1-1-1x x 0 1",
-                                                  "x5o/7/2-1-2/3-3/2-1-2/7/o5x x 0 1",
-                                                  "x5o/7/3-3/2---2/3-3/7/o5x x 0 1"};
+    if (books.contains(settings.name)) {
+        const auto &book = books.at(settings.name);
+        engine = std::make_shared<BookEngine>(engine, std::make_shared<OpeningBook>(book.file), book.depth);
+    }
+    return std::make_shared<ScoreEngine>(engine, scores);
+}
 
 const std::string human_engine_name = "Human player";
 const std::string example_engine_name = "Example engine";
@@ -93,6 +106,10 @@ const std::string default_settings_string =
     "        \"time\": 15000,"
     "        \"inc\": 1000"
     "    },"
+    "    \"match\": {"
+    "        \"games\": 100,"
+    "        \"concurrency\": 1"
+    "    },"
     "    \"options\": {"
     "        \"debug\": \"false\","
     "        \"threads\": \"1\","
@@ -109,6 +126,10 @@ const std::string default_settings_string =
     "            \"options\": {"
     "                \"ownbook\": \"true\""
     "            }"
+    "        },"
+    "        {"
+    "            \"name\": \"Reference engine\","
+    "            \"builtin\": \"reference\""
     "        }"
     "    ]"
     "}";
@@ -147,6 +168,32 @@ void MainWindow::load_settings() {
 
     std::cout << "Using settings file: " << m_settings_file_path << std::endl;
     const auto settings = GuiSettings(m_settings_file_path.string());
+    m_books = settings.books;
+    m_watchdog = settings.watchdog;
+    m_adjudication = settings.adjudication;
+    m_match_settings = settings.match;
+    // The old endpoint has to release its port first
+    m_metrics_server = nullptr;
+    if (settings.metrics.port != 0) {
+        try {
+            m_metrics_server = std::make_unique<MetricsServer>(settings.metrics);
+        } catch (const std::exception &e) {
+            std::cout << e.what() << std::endl;
+        }
+    }
+    if (!m_match_settings.adjudication.has_value()) {
+        m_match_settings.adjudication = m_adjudication;
+    }
+    // Not games.pgn, resuming a match cuts its PGN back to the journal and would take the GUI's games with it
+    if (m_match_settings.pgn_out.empty()) {
+        m_match_settings.pgn_out = QCoreApplication::applicationDirPath().toStdString() + "/match.pgn";
+    }
+    if (m_match_settings.journal.empty()) {
+        m_match_settings.journal = QCoreApplication::applicationDirPath().toStdString() + "/match.journal";
+    }
+    if (m_match_settings.ratings_out.empty()) {
+        m_match_settings.ratings_out = QCoreApplication::applicationDirPath().toStdString() + "/ratings.txt";
+    }
     m_engines.clear();
     for (const auto &engine : settings.engines) {
         m_engines[engine.name] = engine;
@@ -170,7 +217,7 @@ void MainWindow::load_settings() {
     m_inc_spin_box->setTime(QTime(0, 0, 0).addMSecs(std::max(settings.tc.winc, settings.tc.binc)));
 }
 
-MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_settings_file_path(getSettingsFilePath()) {
+MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_settings_file_path(settings_file_path()) {
     QGridLayout *tc_layout = new QGridLayout();
     QLabel *time_label = new QLabel("Time (HH:mm:ss): ", this);
     QLabel *inc_label = new QLabel("Increment (mm:ss): ", this);
@@ -183,6 +230,8 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_settings_file_p
     QHBoxLayout *main_layout = new QHBoxLayout(central_widget);
     QVBoxLayout *left_layout = new QVBoxLayout();
     m_toggle_game_button = new QPushButton("Start Game", this);
+    m_toggle_match_button = new QPushButton("Start Match", this);
+    m_match_status = new QLabel(this);
     m_engine_selection1 = new QComboBox(this);
     m_engine_selection2 = new QComboBox(this);
     m_clock_piece_white = new QLabel(this);
@@ -197,6 +246,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_settings_file_p
     m_turn_radio_black = new QRadioButton;
     m_clock_white = new CountdownTimer(this);
     m_clock_black = new CountdownTimer(this);
+    m_think_time = new QLabel(this);
     QHBoxLayout *set_fen_layout = new QHBoxLayout();
     QLabel *fen_label = new QLabel("FEN: ", this);
     m_fen_text_field = new QLineEdit(this);
@@ -204,6 +254,10 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_settings_file_p
     m_start_pos_selection = new QComboBox(this);
     QVBoxLayout *right_layout = new QVBoxLayout();
     m_pgn_text_field = new QTextEdit(this);
+    m_explorer_panel = new ExplorerPanel(this);
+    m_ratings_panel = new RatingsPanel(this);
+    m_games_panel = new GamesPanel(this);
+    m_side_tabs = new QTabWidget(this);
     m_human_infinite_time_checkbox = new QCheckBox("Infinite time for human player", this);
     m_piece_theme_selection = new QComboBox(this);
     m_board_theme_selection = new QComboBox(this);
@@ -248,6 +302,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_settings_file_p
         if (this->m_piece_theme_selection->currentIndex() != -1) {
             PieceImages::load(text.toStdString());
             this->m_board_scene->reload();
+            this->m_games_panel->reload();
 
             set_label_piece_pixmap(this->m_clock_piece_white, libataxx::Piece::White, this->m_clock_white->height());
             set_label_piece_pixmap(this->m_clock_piece_black, libataxx::Piece::Black, this->m_clock_black->height());
@@ -265,6 +320,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_settings_file_p
         if (this->m_board_theme_selection->currentIndex() != -1) {
             BoardImage::load(text.toStdString());
             this->m_board_scene->reload();
+            this->m_games_panel->reload();
             this->m_board_theme_selection->setCurrentIndex((-1));
         }
     });
@@ -276,12 +332,22 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_settings_file_p
 
     left_layout->addLayout(engine_selection_layout);
     left_layout->addWidget(m_toggle_game_button);
+    left_layout->addWidget(m_toggle_match_button);
+    left_layout->addWidget(m_match_status);
     left_layout->addWidget(edit_settings_button);
     left_layout->addWidget(m_piece_theme_selection);
     left_layout->addWidget(m_board_theme_selection);
     left_layout->addStretch(1);
     main_layout->addLayout(left_layout);
 
+    connect(m_toggle_match_button, &QPushButton::clicked, [this]() {
+        if (this->m_match_runner == nullptr) {
+            start_match();
+        } else {
+            stop_match();
+        }
+    });
+
     connect(m_toggle_game_button, &QPushButton::clicked, [this]() {
         if (this->m_toggle_game_button->text() == "Start Game") {
             start_game();
@@ -307,8 +373,17 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_settings_file_p
     clock_layout->addWidget(m_turn_radio_black);
     middle_layout->addLayout(clock_layout);
 
-    m_clock_white->set_time(QTime(23, 59, 59));
-    m_clock_black->set_time(QTime(23, 59, 59));
+    m_clock_white->set_time(std::nullopt);
+    m_clock_black->set_time(std::nullopt);
+
+    // Think time of the side to move
+    m_think_time->setAlignment(Qt::AlignCenter);
+    middle_layout->addWidget(m_think_time);
+    for (auto *clock : {m_clock_white, m_clock_black}) {
+        connect(clock, &CountdownTimer::think_time_changed, m_think_time, [this](qint64 ms) {
+            m_think_time->setText(QString("Thinking %1.%2 s").arg(ms / 1000).arg(ms % 1000 / 100));
+        });
+    }
 
     m_board_view->setEnabled(true);
     middle_layout->addWidget(m_board_view);
@@ -319,7 +394,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_settings_file_p
 
     connect(m_board_scene, &BoardScene::new_fen, m_fen_text_field, &QLineEdit::setText);
     connect(m_fen_text_field, &QLineEdit::editingFinished, [this]() {
-        if (m_game_worker == nullptr) {
+        if (m_game_worker == nullptr && m_match_runner == nullptr) {
             m_board_scene->set_board(libataxx::Position(m_fen_text_field->text().toStdString()));
         } else {
             this->m_fen_text_field->setText(QString::fromStdString(m_board_scene->board().get_fen()));
@@ -334,7 +409,8 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_settings_file_p
         m_start_pos_selection->addItem((std::to_string(i + 1) + ". " + start_positions.at(i)).c_str());
     }
     connect(m_start_pos_selection, &QComboBox::currentTextChanged, [this](QString text) {
-        if (this->m_start_pos_selection->currentIndex() != -1 && m_game_worker == nullptr) {
+        if (this->m_start_pos_selection->currentIndex() != -1 && m_game_worker == nullptr &&
+            m_match_runner == nullptr) {
             auto startpos = text.toStdString();
             while (true) {
                 auto c = startpos.front();
@@ -351,9 +427,20 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_settings_file_p
 
     main_layout->addLayout(middle_layout);
 
-    // Create right vertical layout for text field
+    connect(m_board_scene, &BoardScene::new_fen, m_explorer_panel, &ExplorerPanel::set_position);
+    connect(m_explorer_panel, &ExplorerPanel::move_selected, [this](libataxx::Move move) {
+        if (m_game_worker == nullptr && m_match_runner == nullptr) {
+            m_board_scene->on_new_move(move);
+        }
+    });
+
+    // Create right vertical layout for explorer and text field
     m_pgn_text_field->setReadOnly(true);
-    right_layout->addWidget(m_pgn_text_field);
+    m_side_tabs->addTab(m_explorer_panel, "Explorer");
+    m_side_tabs->addTab(m_ratings_panel, "Ratings");
+    m_side_tabs->addTab(m_games_panel, "Games");
+    right_layout->addWidget(m_side_tabs, 1);
+    right_layout->addWidget(m_pgn_text_field, 1);
 
     // Add both layouts to the main layout
     main_layout->addLayout(right_layout);
@@ -394,9 +481,7 @@ void MainWindow::start_game() {
             engine_settings = this->m_engines.at(engine_name);
             engine_settings.tc = tc;
 
-            const auto [send, recv] = get_recv_send_callbacks(engine_name);
-
-            engine = make_engine(engine_settings, send, recv);
+            engine = make_gui_engine(engine_settings, this->m_books, this->m_watchdog);
         }
         return std::pair{engine, engine_settings};
     };
@@ -417,7 +502,9 @@ void MainWindow::start_game() {
 
     this->m_engine_selection1->setEnabled(false);
     this->m_engine_selection2->setEnabled(false);
+    this->m_toggle_match_button->setEnabled(false);
     m_pgn_text_field->setText("");
+    m_think_time->clear();
 
     this->m_toggle_game_button->setText("Stop Game");
 
@@ -428,6 +515,7 @@ void MainWindow::start_game() {
     Q_ASSERT(m_game_worker == nullptr);
     m_game_worker = new GameWorker(
         AdjudicationSettings{},
+        m_adjudication,
         GameSettings{
             .fen = this->m_board_scene->board().get_fen(), .engine1 = engine_setting1, .engine2 = engine_setting2},
         engine1,
@@ -458,13 +546,16 @@ void MainWindow::start_game() {
         &GameWorker::finished_game,
         this,
         [this](GameThingy info) {
-            m_pgn_text_field->setText(QString::fromStdString(get_pgn(
-                PGNSettings{
+            const auto pgn = get_pgn(PGNSettings{},
+                                     this->m_engine_selection1->currentText().toStdString(),
+                                     this->m_engine_selection2->currentText().toStdString(),
+                                     info);
+            show_pgn(info);
+
+            // Finished games are kept for the opening explorer
+            std::ofstream games_file(ExplorerPanel::default_games_path(), std::ios::app);
+            games_file << pgn << "\n\n";
 
-                },
-                this->m_engine_selection1->currentText().toStdString(),
-                this->m_engine_selection2->currentText().toStdString(),
-                info)));
             this->stop_game();
         },
         Qt::QueuedConnection);
@@ -474,15 +565,8 @@ void MainWindow::start_game() {
         &GameWorker::new_move,
         this,
         [this](GameThingy info) {
-            this->m_board_scene->on_new_move(info.history.back().move);
-
-            m_pgn_text_field->setText(QString::fromStdString(get_pgn(
-                PGNSettings{
-
-                },
-                this->m_engine_selection1->currentText().toStdString(),
-                this->m_engine_selection2->currentText().toStdString(),
-                info)));
+            show_move(info.history.back().move);
+            show_pgn(info);
         },
         Qt::QueuedConnection);
 
@@ -492,32 +576,22 @@ void MainWindow::start_game() {
         &GameWorker::update_time_control,
         this,
         [this](SearchSettings tc1, SearchSettings tc2, libataxx::Side side_to_move) {
-            if (tc2.type == SearchSettings::Type::Time) {
-                m_clock_white->set_time(QTime(0, 0).addMSecs(tc2.wtime));
-            } else {
-                m_clock_white->set_time(QTime(23, 59, 59));
-            }
-
-            if (tc1.type == SearchSettings::Type::Time) {
-                m_clock_black->set_time(QTime(0, 0).addMSecs(tc1.btime));
-            } else {
-                m_clock_black->set_time(QTime(23, 59, 59));
-            }
+            // Clocks without a time limit run too, for the think time
+            m_clock_white->set_time(tc2.type == SearchSettings::Type::Time ? std::optional<qint64>(tc2.wtime)
+                                                                          : std::nullopt);
+            m_clock_black->set_time(tc1.type == SearchSettings::Type::Time ? std::optional<qint64>(tc1.btime)
+                                                                          : std::nullopt);
 
             if (side_to_move == libataxx::Side::Black) {
                 m_clock_white->stop_clock();
-                if (tc1.type == SearchSettings::Type::Time) {
-                    m_clock_black->start_clock();
-                }
+                m_clock_black->start_clock();
 
                 m_turn_radio_white->setChecked(false);
                 m_turn_radio_black->setChecked(true);
 
             } else {
                 m_clock_black->stop_clock();
-                if (tc2.type == SearchSettings::Type::Time) {
-                    m_clock_white->start_clock();
-                }
+                m_clock_white->start_clock();
 
                 m_turn_radio_black->setChecked(false);
                 m_turn_radio_white->setChecked(true);
@@ -540,12 +614,298 @@ void MainWindow::stop_game() {
 
     m_engine_selection1->setEnabled(true);
     m_engine_selection2->setEnabled(true);
+    m_toggle_match_button->setEnabled(true);
     m_toggle_game_button->setText("Start Game");
     m_fen_text_field->setReadOnly(false);
     m_fen_set_fen->setEnabled(true);
     m_start_pos_selection->setEnabled(true);
 }
 
+void MainWindow::start_match() {
+    auto names = m_match_settings.engines;
+    if (names.empty()) {
+        names = {m_engine_selection1->currentText().toStdString(), m_engine_selection2->currentText().toStdString()};
+    }
+    if (names.size() < 2) {
+        QMessageBox::warning(this, "Can't start match", "A match needs at least two engines");
+        return;
+    }
+
+    const int time = m_time_spin_box->time().msecsSinceStartOfDay();
+    const int inc = m_inc_spin_box->time().msecsSinceStartOfDay();
+    std::vector<EngineSettings> engines;
+    for (const auto &name : names) {
+        if (name == human_engine_name) {
+            QMessageBox::warning(this, "Can't start match", "Matches are played between engines only");
+            return;
+        } else if (!m_engines.contains(name)) {
+            QMessageBox::warning(this, "Can't start match", QString::fromStdString("Unknown engine " + name));
+            return;
+        }
+        engines.push_back(m_engines.at(name));
+        engines.back().tc = SearchSettings::as_time(time, time, inc, inc);
+    }
+
+    ResourcePlan plan;
+    try {
+        plan = plan_resources(engines, m_match_settings.concurrency, m_match_settings.resources);
+    } catch (const std::exception &e) {
+        QMessageBox::warning(this, "Can't start match", e.what());
+        return;
+    }
+    std::cout << plan.report << std::flush;
+    m_match_status->setToolTip(QString::fromStdString(plan.report));
+
+    Q_ASSERT(m_match_runner == nullptr);
+    try {
+        m_match_runner = new MatchRunner(
+            m_match_settings,
+            plan.engines,
+            [books = m_books, watchdog = m_watchdog](const EngineSettings &settings) {
+                return make_gui_engine(settings, books, watchdog);
+            },
+            this);
+    } catch (const std::exception &e) {
+        QMessageBox::warning(this, "Can't start match", e.what());
+        return;
+    }
+    m_match_score = {};
+    m_ratings_panel->clear();
+    m_games_panel->clear();
+
+    // The main board follows the games of the first slot, the games tab shows all of them
+    connect(m_match_runner, &MatchRunner::game_started, this, [this](int slot, MatchGame game) {
+        if (slot == 0) {
+            show_board(libataxx::Position(game.fen));
+        }
+        const auto &engines = m_match_runner->engines();
+        const auto title = QString("%1. %2 - %3")
+                               .arg(game.id + 1)
+                               .arg(QString::fromStdString(engines.at(game.engine1).name))
+                               .arg(QString::fromStdString(engines.at(game.engine2).name));
+        m_games_panel->set_game(slot, title, libataxx::Position(game.fen));
+    });
+    connect(m_match_runner, &MatchRunner::new_move, this, [this](int slot, GameThingy info) {
+        if (slot == 0) {
+            show_move(info.history.back().move);
+        }
+        m_games_panel->on_new_move(slot, info.history.back().move);
+    });
+    connect(m_match_runner,
+            &MatchRunner::game_finished,
+            this,
+            [this](int slot, MatchGame game, GameThingy result, GameResult outcome) {
+                m_games_panel->set_result(slot, QString::fromStdString(result_string(result.result)));
+                count_match_game(game, outcome);
+            });
+    connect(m_match_runner,
+            &MatchRunner::game_failed,
+            this,
+            [this](int slot, MatchGame game, QString reason, GameResult outcome) {
+                m_games_panel->set_result(slot, "Failed");
+                std::cout << reason.toStdString() << std::endl;
+                count_match_game(game, outcome);
+            });
+    connect(m_match_runner, &MatchRunner::engine_failed, this, [this](int, MatchGame, int engine, QString reason) {
+        std::cout << m_match_runner->engines().at(engine).name << " " << reason.toStdString() << " and lost the game"
+                  << std::endl;
+    });
+    connect(m_match_runner, &MatchRunner::ratings_updated, this, [this]() {
+        std::vector<std::string> names;
+        for (const auto &engine : m_match_runner->engines()) {
+            names.push_back(engine.name);
+        }
+        m_ratings_panel->set_ratings(names, m_match_runner->ratings());
+    });
+    connect(m_match_runner, &MatchRunner::match_finished, this, &MainWindow::stop_match);
+
+    auto resume = m_match_runner->resumable_journal();
+    if (resume.has_value()) {
+        const auto answer = QMessageBox::question(
+            this,
+            "Resume match",
+            QString("This match was interrupted after %1 games. Continue where it stopped?").arg(resume->finished.size()));
+        if (answer != QMessageBox::Yes) {
+            resume = std::nullopt;
+        }
+    }
+
+    try {
+        m_match_runner->start(m_board_scene->board().get_fen(), resume);
+    } catch (const std::exception &e) {
+        delete m_match_runner;
+        m_match_runner = nullptr;
+        QMessageBox::warning(this, "Failed to start match", e.what());
+        return;
+    }
+    if (m_match_runner == nullptr) {
+        return;
+    }
+    if (resume.has_value()) {
+        m_match_score.played = static_cast<int>(resume->finished.size());
+        const auto &ratings = m_match_runner->ratings();
+        for (std::size_t opponent = 1; opponent < ratings.players(); ++opponent) {
+            const auto score = ratings.score(0, opponent);
+            m_match_score.wins += score.wins;
+            m_match_score.draws += score.draws;
+            m_match_score.losses += score.losses;
+        }
+    }
+
+    m_engine_selection1->setEnabled(false);
+    m_engine_selection2->setEnabled(false);
+    m_toggle_game_button->setEnabled(false);
+    m_fen_text_field->setReadOnly(true);
+    m_fen_set_fen->setEnabled(false);
+    m_start_pos_selection->setEnabled(false);
+    m_toggle_match_button->setText("Stop Match");
+    update_match_status();
+}
+
+void MainWindow::stop_match() {
+    if (m_match_runner != nullptr) {
+        m_match_runner->stop();
+        m_match_runner->deleteLater();
+        m_match_runner = nullptr;
+    }
+
+    m_engine_selection1->setEnabled(true);
+    m_engine_selection2->setEnabled(true);
+    m_toggle_game_button->setEnabled(true);
+    m_fen_text_field->setReadOnly(false);
+    m_fen_set_fen->setEnabled(true);
+    m_start_pos_selection->setEnabled(true);
+    m_toggle_match_button->setText("Start Match");
+}
+
+void MainWindow::count_match_game(const MatchGame &game, GameResult outcome) {
+    m_match_score.played++;
+
+    // Counted for the first engine
+    if (outcome != GameResult::None && (game.engine1 == 0 || game.engine2 == 0)) {
+        const auto points = black_points(outcome);
+        const auto score = game.engine1 == 0 ? points : 1.0 - points;
+        if (score == 1.0) {
+            m_match_score.wins++;
+        } else if (score == 0.0) {
+            m_match_score.losses++;
+        } else {
+            m_match_score.draws++;
+        }
+    }
+    update_match_status();
+}
+
+void MainWindow::update_match_status() {
+    const auto &s = m_match_score;
+    const int total = m_match_runner != nullptr ? m_match_runner->total_games() : s.played;
+    m_match_status->setText(QString("Match %1/%2: +%3 =%4 -%5")
+                                .arg(s.played)
+                                .arg(total)
+                                .arg(s.wins)
+                                .arg(s.draws)
+                                .arg(s.losses));
+
+    if (m_match_runner != nullptr && m_match_runner->sprt().has_value()) {
+        const auto &sprt = m_match_runner->sprt().value();
+        const auto verdict = m_match_runner->sprt_result();
+        m_match_status->setText(m_match_status->text() +
+                                QString("\nLLR %1 (%2, %3)%4")
+                                    .arg(sprt.llr(m_match_runner->pentanomial()), 0, 'f', 2)
+                                    .arg(sprt.lower_bound(), 0, 'f', 2)
+                                    .arg(sprt.upper_bound(), 0, 'f', 2)
+                                    .arg(verdict == SprtResult::AcceptH1   ? " H1 accepted"
+                                         : verdict == SprtResult::AcceptH0 ? " H0 accepted"
+                                                                           : ""));
+    }
+}
+
+void MainWindow::changeEvent(QEvent *event) {
+    QMainWindow::changeEvent(event);
+    if (event->type() == QEvent::WindowStateChange) {
+        update_power_mode();
+    }
+}
+
+void MainWindow::showEvent(QShowEvent *event) {
+    QMainWindow::showEvent(event);
+    // Expose events tell when the window is covered, the platform window only exists once it's shown
+    if (windowHandle() != nullptr) {
+        windowHandle()->installEventFilter(this);
+    }
+    update_power_mode();
+}
+
+void MainWindow::hideEvent(QHideEvent *event) {
+    QMainWindow::hideEvent(event);
+    update_power_mode();
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event) {
+    if (watched == windowHandle() && event->type() == QEvent::Expose) {
+        // Let the window handle the event first so isExposed() is up to date
+        QMetaObject::invokeMethod(this, &MainWindow::update_power_mode, Qt::QueuedConnection);
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+void MainWindow::update_power_mode() {
+    const bool low_power =
+        !isVisible() || isMinimized() || (windowHandle() != nullptr && !windowHandle()->isExposed());
+    if (low_power == m_low_power) {
+        return;
+    }
+    m_low_power = low_power;
+    m_clock_white->set_suspended(low_power);
+    m_clock_black->set_suspended(low_power);
+    m_games_panel->set_suspended(low_power);
+    if (low_power) {
+        return;
+    }
+
+    if (m_hidden_board.has_value()) {
+        m_board_scene->set_board(m_hidden_board.value());
+        m_hidden_board = std::nullopt;
+    }
+    if (m_hidden_pgn.has_value()) {
+        const auto info = std::move(m_hidden_pgn.value());
+        m_hidden_pgn = std::nullopt;
+        show_pgn(info);
+    }
+}
+
+void MainWindow::show_board(const libataxx::Position &pos) {
+    if (m_low_power) {
+        m_hidden_board = pos;
+    } else {
+        m_board_scene->set_board(pos);
+    }
+}
+
+void MainWindow::show_move(const libataxx::Move &move) {
+    if (!m_low_power) {
+        m_board_scene->on_new_move(move);
+        return;
+    }
+    if (!m_hidden_board.has_value()) {
+        m_hidden_board = m_board_scene->board();
+    }
+    m_hidden_board->makemove(move);
+}
+
+void MainWindow::show_pgn(const GameThingy &info) {
+    if (m_low_power) {
+        m_hidden_pgn = info;
+        return;
+    }
+    const TraceSpan span("pgn", "gui");
+    m_pgn_text_field->setText(QString::fromStdString(get_pgn(PGNSettings{},
+                                                             m_engine_selection1->currentText().toStdString(),
+                                                             m_engine_selection2->currentText().toStdString(),
+                                                             info)));
+}
+
 MainWindow::~MainWindow() {
+    stop_match();
     stop_game();
 }
\ No newline at end of file
@@ -10,15 +10,24 @@
 #include <QMainWindow>
 #include <QPushButton>
 #include <QRadioButton>
+#include <QTabWidget>
 #include <QTextEdit>
 #include <QThread>
 #include <QTimeEdit>
+#include <QWindow>
 #include <map>
+#include <optional>
 #include "boardview/boardscene.hpp"
 #include "boardview/boardview.hpp"
 #include "countdowntimer.hpp"
+#include "explorerpanel.hpp"
+#include "gamespanel.hpp"
 #include "gameworker.hpp"
+#include "guisettings.hpp"
 #include "humanengine.hpp"
+#include "match/matchrunner.hpp"
+#include "metrics/metricsserver.hpp"
+#include "ratingspanel.hpp"
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -32,8 +41,26 @@ class MainWindow : public QMainWindow {
     void start_game();
     void stop_game();
     void edit_settings();
+    void start_match();
+    void stop_match();
+
+   protected:
+    void changeEvent(QEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
    private:
+    // Adds a finished or failed match game to the score shown in the status line
+    void count_match_game(const MatchGame& game, GameResult outcome);
+    void update_match_status();
+    // Low power mode while the window is hidden, minimized or covered: no clock ticks, animations or
+    // text updates. The games go on and the window catches up in one pass when it's shown again.
+    void update_power_mode();
+    void show_board(const libataxx::Position& pos);
+    void show_move(const libataxx::Move& move);
+    void show_pgn(const GameThingy& info);
+
     BoardScene* m_board_scene{nullptr};
     BoardView* m_board_view{nullptr};
     std::shared_ptr<HumanEngine> m_human_engine;
@@ -43,6 +70,8 @@ class MainWindow : public QMainWindow {
     QComboBox* m_start_pos_selection{nullptr};
 
     QPushButton* m_toggle_game_button{nullptr};
+    QPushButton* m_toggle_match_button{nullptr};
+    QLabel* m_match_status{nullptr};
 
     QTimeEdit* m_time_spin_box{nullptr};
     QTimeEdit* m_inc_spin_box{nullptr};
@@ -51,14 +80,29 @@ class MainWindow : public QMainWindow {
     QRadioButton* m_turn_radio_black{nullptr};
     CountdownTimer* m_clock_white{nullptr};
     CountdownTimer* m_clock_black{nullptr};
+    QLabel* m_think_time{nullptr};
     QLabel* m_clock_piece_white{nullptr};
     QLabel* m_clock_piece_black{nullptr};
 
     QTextEdit* m_pgn_text_field{nullptr};
+    ExplorerPanel* m_explorer_panel{nullptr};
+    RatingsPanel* m_ratings_panel{nullptr};
+    GamesPanel* m_games_panel{nullptr};
+    QTabWidget* m_side_tabs{nullptr};
 
     GameWorker* m_game_worker{nullptr};
     QThread m_worker_thread;
 
+    MatchRunner* m_match_runner{nullptr};
+    MatchSettings m_match_settings;
+    // Games played, and the first engine's results
+    struct MatchScore {
+        int played = 0;
+        int wins = 0;
+        int draws = 0;
+        int losses = 0;
+    } m_match_score;
+
     QLabel* m_selection_piece_white{nullptr};
     QLabel* m_selection_piece_black{nullptr};
     QComboBox* m_engine_selection1{nullptr};
@@ -71,4 +115,13 @@ class MainWindow : public QMainWindow {
 
     std::filesystem::path m_settings_file_path;
     std::map<std::string, EngineSettings> m_engines;
+    std::map<std::string, BookSettings> m_books;
+    WatchdogSettings m_watchdog;
+    AdjudicationRules m_adjudication;
+    std::unique_ptr<MetricsServer> m_metrics_server;
+
+    bool m_low_power = false;
+    // What the board and the PGN pane will show once the low power mode ends
+    std::optional<libataxx::Position> m_hidden_board;
+    std::optional<GameThingy> m_hidden_pgn;
 };
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file, shared between processes through the page cache.
+class MappedFile {
+   public:
+    MappedFile() = default;
+
+    explicit MappedFile(const std::string &path)
+        : m_mapping(path.c_str(), boost::interprocess::read_only),
+          m_region(m_mapping, boost::interprocess::read_only) {
+    }
+
+    [[nodiscard]] const char *data() const {
+        return static_cast<const char *>(m_region.get_address());
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return m_region.get_size();
+    }
+
+    [[nodiscard]] bool is_open() const {
+        return m_region.get_address() != nullptr;
+    }
+
+   private:
+    boost::interprocess::file_mapping m_mapping;
+    boost::interprocess::mapped_region m_region;
+};
@@ -0,0 +1,162 @@
+#include "cpuaffinity.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <tuple>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace {
+
+[[maybe_unused]] int read_int(const std::filesystem::path &path, int fallback) {
+    std::ifstream file(path);
+    int value = fallback;
+    if (!(file >> value)) {
+        return fallback;
+    }
+    return value;
+}
+
+}  // namespace
+
+std::vector<int> thread_affinity() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+bool set_thread_affinity([[maybe_unused]] const std::vector<int> &cpus) {
+#ifdef __linux__
+    if (cpus.empty()) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const auto cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    // 0 is the calling thread, not the whole process
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+std::vector<LogicalCpu> detect_cpus() {
+    std::vector<LogicalCpu> cpus;
+#ifdef __linux__
+    const std::filesystem::path root = "/sys/devices/system/cpu";
+    for (const auto id : thread_affinity()) {
+        const auto dir = root / ("cpu" + std::to_string(id));
+        LogicalCpu cpu;
+        cpu.id = id;
+        cpu.core = read_int(dir / "topology" / "core_id", id);
+        cpu.package = read_int(dir / "topology" / "physical_package_id", 0);
+
+        std::error_code ec;
+        for (const auto &entry : std::filesystem::directory_iterator(dir, ec)) {
+            const auto name = entry.path().filename().string();
+            if (name.rfind("node", 0) == 0 && name.size() > 4 && std::isdigit(static_cast<unsigned char>(name[4]))) {
+                cpu.node = std::stoi(name.substr(4));
+                break;
+            }
+        }
+        cpus.push_back(cpu);
+    }
+#endif
+    return cpus;
+}
+
+CpuLayout plan_cpu_layout(const std::vector<LogicalCpu> &cpus, int num_slots) {
+    CpuLayout layout;
+    if (cpus.empty() || num_slots < 1) {
+        return layout;
+    }
+
+    // Physical cores in node order, each with its SMT siblings
+    std::map<std::tuple<int, int, int>, std::vector<int>> by_core;
+    for (const auto &cpu : cpus) {
+        by_core[{cpu.node, cpu.package, cpu.core}].push_back(cpu.id);
+    }
+    std::vector<std::vector<int>> cores;
+    for (auto &[key, siblings] : by_core) {
+        cores.push_back(std::move(siblings));
+    }
+
+    if (static_cast<int>(cores.size()) > num_slots) {
+        layout.gui = cores.front();
+        cores.erase(cores.begin());
+    }
+
+    layout.slot_cpus.resize(num_slots);
+    if (static_cast<int>(cores.size()) >= num_slots) {
+        // Neighbouring cores share a node, so consecutive blocks keep slots on one node where possible
+        const std::size_t per_slot = cores.size() / num_slots;
+        for (int slot = 0; slot < num_slots; ++slot) {
+            for (std::size_t i = 0; i < per_slot; ++i) {
+                const auto &core = cores[slot * per_slot + i];
+                layout.slot_cpus[slot].insert(layout.slot_cpus[slot].end(), core.begin(), core.end());
+            }
+        }
+    } else {
+        // More slots than cores, spread the logical CPUs and let siblings be shared
+        std::vector<int> logical;
+        for (std::size_t i = 0;; ++i) {
+            bool any = false;
+            for (const auto &core : cores) {
+                if (i < core.size()) {
+                    logical.push_back(core[i]);
+                    any = true;
+                }
+            }
+            if (!any) {
+                break;
+            }
+        }
+        for (int slot = 0; slot < num_slots; ++slot) {
+            layout.slot_cpus[slot].push_back(logical[slot % logical.size()]);
+        }
+    }
+
+    for (auto &slot : layout.slot_cpus) {
+        std::sort(slot.begin(), slot.end());
+    }
+    if (layout.gui.empty()) {
+        for (const auto &cpu : cpus) {
+            layout.gui.push_back(cpu.id);
+        }
+    }
+    return layout;
+}
+
+std::string describe_cpu_layout(const CpuLayout &layout) {
+    const auto list = [](const std::vector<int> &cpus) {
+        std::string text;
+        for (const auto cpu : cpus) {
+            text += (text.empty() ? "" : ",") + std::to_string(cpu);
+        }
+        return text;
+    };
+
+    std::ostringstream out;
+    out << "GUI: CPUs " << list(layout.gui) << "\n";
+    for (std::size_t i = 0; i < layout.slot_cpus.size(); ++i) {
+        out << "Slot " << i + 1 << ": CPUs " << list(layout.slot_cpus[i]) << "\n";
+    }
+    return out.str();
+}
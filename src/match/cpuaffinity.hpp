@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+struct LogicalCpu {
+    int id = 0;
+    int core = 0;
+    int package = 0;
+    int node = 0;
+};
+
+struct CpuLayout {
+    // CPUs for the GUI and the worker threads
+    std::vector<int> gui;
+    // CPUs for the engines of every concurrency slot, empty if pinning isn't possible
+    std::vector<std::vector<int>> slot_cpus;
+};
+
+// The CPUs this process may run on with their place in the machine. Empty where this isn't supported.
+[[nodiscard]] std::vector<LogicalCpu> detect_cpus();
+
+// Gives every slot whole physical cores, SMT siblings included, from as few NUMA nodes as possible.
+// The first core is kept for the GUI when there are enough. Slots share cores only when there
+// are more slots than cores.
+[[nodiscard]] CpuLayout plan_cpu_layout(const std::vector<LogicalCpu> &cpus, int num_slots);
+
+[[nodiscard]] std::string describe_cpu_layout(const CpuLayout &layout);
+
+// Affinity of the calling thread. Processes started by the thread inherit it.
+[[nodiscard]] std::vector<int> thread_affinity();
+bool set_thread_affinity(const std::vector<int> &cpus);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <../core/play.hpp>
+
+enum class GameResult
+{
+    BlackWin,
+    WhiteWin,
+    Draw,
+    None,
+};
+
+[[nodiscard]] inline GameResult game_result(const GameThingy &game) {
+    switch (game.result) {
+        case GameOutcome::BlackWin:
+            return GameResult::BlackWin;
+        case GameOutcome::WhiteWin:
+            return GameResult::WhiteWin;
+        case GameOutcome::Draw:
+            return GameResult::Draw;
+        default:
+            return GameResult::None;
+    }
+}
+
+// Score of engine1 (Black) from 0 to 1
+[[nodiscard]] inline double black_points(GameResult result) {
+    return result == GameResult::BlackWin ? 1.0 : result == GameResult::Draw ? 0.5 : 0.0;
+}
@@ -0,0 +1,190 @@
+#include "journal.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Lines that come in while a batch is synced wait for the next batch
+constexpr std::chrono::milliseconds batch_interval{50};
+
+std::string result_token(GameResult result) {
+    switch (result) {
+        case GameResult::BlackWin:
+            return "1-0";
+        case GameResult::WhiteWin:
+            return "0-1";
+        case GameResult::Draw:
+            return "1/2-1/2";
+        default:
+            return "*";
+    }
+}
+
+GameResult parse_result(const std::string &token) {
+    if (token == "1-0") {
+        return GameResult::BlackWin;
+    } else if (token == "0-1") {
+        return GameResult::WhiteWin;
+    } else if (token == "1/2-1/2") {
+        return GameResult::Draw;
+    }
+    return GameResult::None;
+}
+
+void sync_file(std::FILE *file) {
+    std::fflush(file);
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
+
+}  // namespace
+
+MatchJournal::MatchJournal(const std::string &path, bool append) : m_path(path) {
+    m_file = std::fopen(path.c_str(), append ? "ab" : "wb");
+    if (m_file == nullptr) {
+        throw std::runtime_error("Could not open match journal " + path);
+    }
+    m_thread = std::thread([this]() {
+        run();
+    });
+}
+
+MatchJournal::~MatchJournal() {
+    close();
+}
+
+void MatchJournal::close() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        m_quit = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+void MatchJournal::remove() {
+    close();
+    std::error_code ec;
+    std::filesystem::remove(m_path, ec);
+}
+
+void MatchJournal::append(std::string line) {
+    {
+        std::lock_guard lock(m_mutex);
+        m_pending.push_back(std::move(line));
+    }
+    m_cv.notify_one();
+}
+
+void MatchJournal::run() {
+    std::vector<std::string> batch;
+    std::unique_lock lock(m_mutex);
+    while (true) {
+        m_cv.wait(lock, [this]() {
+            return m_quit || !m_pending.empty();
+        });
+        if (m_pending.empty() && m_quit) {
+            break;
+        }
+        batch.swap(m_pending);
+        lock.unlock();
+
+        for (const auto &line : batch) {
+            std::fputs(line.c_str(), m_file);
+            std::fputc('\n', m_file);
+        }
+        sync_file(m_file);
+        batch.clear();
+        std::this_thread::sleep_for(batch_interval);
+
+        lock.lock();
+    }
+}
+
+void MatchJournal::start(const std::string &fingerprint, std::uint64_t pgn_size) {
+    append("match " + fingerprint);
+    append("pgn " + std::to_string(pgn_size));
+}
+
+void MatchJournal::scheduled(const MatchGame &game) {
+    std::ostringstream line;
+    line << "scheduled " << game.id << " " << game.pair << " " << game.engine1 << " " << game.engine2 << " "
+         << game.fen;
+    append(line.str());
+}
+
+void MatchJournal::finished(const MatchGame &game, GameResult result, std::uint64_t pgn_size) {
+    std::ostringstream line;
+    line << "finished " << game.id << " " << result_token(result) << " " << pgn_size;
+    append(line.str());
+}
+
+void MatchJournal::engine_failed(int engine, bool crashed) {
+    append("failure " + std::to_string(engine) + " " + (crashed ? "crash" : "hang"));
+}
+
+std::optional<JournalState> MatchJournal::read(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+
+    JournalState state;
+    std::string line;
+    while (std::getline(file, line)) {
+        // The last line may have been cut short
+        if (file.eof()) {
+            break;
+        }
+
+        std::istringstream in(line);
+        std::string type;
+        in >> type;
+        if (type == "match") {
+            std::getline(in >> std::ws, state.fingerprint);
+        } else if (type == "pgn") {
+            in >> state.pgn_size;
+        } else if (type == "scheduled") {
+            MatchGame game;
+            if (in >> game.id >> game.pair >> game.engine1 >> game.engine2 && std::getline(in >> std::ws, game.fen)) {
+                state.scheduled.push_back(game);
+            }
+        } else if (type == "finished") {
+            int id = 0;
+            std::string result;
+            std::uint64_t pgn_size = 0;
+            if (in >> id >> result >> pgn_size) {
+                state.finished[id] = parse_result(result);
+                state.pgn_size = pgn_size;
+            }
+        } else if (type == "failure") {
+            int engine = 0;
+            std::string kind;
+            if (in >> engine >> kind) {
+                state.failures.emplace_back(engine, kind == "crash");
+            }
+        }
+    }
+
+    if (state.fingerprint.empty()) {
+        return std::nullopt;
+    }
+    return state;
+}
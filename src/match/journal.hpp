@@ -0,0 +1,64 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gameresult.hpp"
+#include "matchgame.hpp"
+
+// What a journal says about an interrupted match
+struct JournalState {
+    // Identifies the match settings the journal was written for
+    std::string fingerprint;
+    // Every scheduled game in scheduling order
+    std::vector<MatchGame> scheduled;
+    // Result by game id, GameResult::None for games that failed
+    std::map<int, GameResult> finished;
+    // Engine index and whether it crashed (or hung) for every forfeit
+    std::vector<std::pair<int, bool>> failures;
+    // Size of the PGN file after the last finished game
+    std::uint64_t pgn_size = 0;
+};
+
+// Append-only log of a match, one line per event, so an interrupted match can be resumed.
+// Lines are written and synced to disk in batches by a thread of its own, callers never wait for
+// the disk. A line cut short by a crash is ignored when the journal is read.
+class MatchJournal {
+   public:
+    // Starts a new journal, or continues an existing one when resuming
+    MatchJournal(const std::string &path, bool append);
+    ~MatchJournal();
+
+    MatchJournal(const MatchJournal &) = delete;
+    MatchJournal &operator=(const MatchJournal &) = delete;
+
+    void start(const std::string &fingerprint, std::uint64_t pgn_size);
+    void scheduled(const MatchGame &game);
+    void finished(const MatchGame &game, GameResult result, std::uint64_t pgn_size);
+    void engine_failed(int engine, bool crashed);
+
+    // Closes the journal and deletes it, for matches that are complete
+    void remove();
+
+    // Reads the journal in one pass, nullopt if there is none or it is empty
+    [[nodiscard]] static std::optional<JournalState> read(const std::string &path);
+
+   private:
+    void append(std::string line);
+    void run();
+    void close();
+
+    std::string m_path;
+    std::FILE *m_file = nullptr;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<std::string> m_pending;
+    bool m_quit = false;
+    std::thread m_thread;
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+struct MatchGame {
+    int id = 0;
+    // Both games of a pair share the opening and swap colours
+    int pair = 0;
+    std::string fen;
+    // Indices into the match's engines, engine1 plays Black
+    int engine1 = 0;
+    int engine2 = 1;
+};
@@ -0,0 +1,564 @@
+#include "matchrunner.hpp"
+#include <../core/pgn.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "../engines/affinityengine.hpp"
+#include "../metrics/metrics.hpp"
+#include "../tracer.hpp"
+
+namespace {
+
+// Whether the PGN after offset only holds games of this match, the last one maybe cut short by a crash.
+// The file isn't truncated otherwise, it might be somebody else's games.
+bool is_match_output(const std::string &path, std::uint64_t offset, const std::vector<EngineSettings> &engines) {
+    std::ifstream file(path);
+    if (!file.seekg(static_cast<std::streamoff>(offset))) {
+        return false;
+    }
+    std::string line;
+    bool first = true;
+    while (std::getline(file, line)) {
+        if (line.empty() || line == "\r") {
+            continue;
+        }
+        // Every game starts with its tags
+        if (first && line.front() != '[') {
+            return false;
+        }
+        first = false;
+        for (const std::string tag : {"[White \"", "[Black \""}) {
+            if (!line.starts_with(tag)) {
+                continue;
+            }
+            const auto end = line.find('"', tag.size());
+            if (end == std::string::npos) {
+                // Cut short, only possible in the last line
+                return file.peek() == std::ifstream::traits_type::eof();
+            }
+            const auto name = line.substr(tag.size(), end - tag.size());
+            if (std::none_of(engines.begin(), engines.end(), [&name](const EngineSettings &e) {
+                    return e.name == name;
+                })) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+MatchRunner::MatchRunner(const MatchSettings &settings,
+                         std::vector<EngineSettings> engines,
+                         GameWorker::EngineFactory engine_factory,
+                         QObject *parent)
+    : QObject(parent),
+      m_settings(settings),
+      m_engines(std::move(engines)),
+      m_engine_factory(std::move(engine_factory)),
+      m_ratings(m_engines.size()),
+      m_failures(m_engines.size()) {
+    const int num_engines = static_cast<int>(m_engines.size());
+    for (int i = 0; i < num_engines; ++i) {
+        for (int j = i + 1; j < num_engines; ++j) {
+            if (m_settings.format == MatchSettings::Format::RoundRobin || i == 0) {
+                m_pairings.push_back(Pairing{.engine1 = i, .engine2 = j});
+            }
+        }
+    }
+    if (m_settings.sprt.has_value() && num_engines == 2) {
+        m_sprt.emplace(m_settings.sprt.value());
+    }
+}
+
+MatchRunner::~MatchRunner() {
+    stop();
+}
+
+int MatchRunner::pairs_per_pairing() const {
+    return (std::max(1, m_settings.games) + 1) / 2;
+}
+
+int MatchRunner::total_games() const {
+    return static_cast<int>(m_pairings.size()) * pairs_per_pairing() * 2;
+}
+
+std::string MatchRunner::fingerprint() const {
+    std::ostringstream out;
+    out << "format=" << static_cast<int>(m_settings.format) << ";games=" << m_settings.games;
+    for (const auto &engine : m_engines) {
+        out << ";engine=" << engine.name;
+    }
+    if (m_settings.openings.has_value()) {
+        const auto &openings = m_settings.openings.value();
+        out << ";openings=" << openings.file << "," << static_cast<int>(openings.order) << "," << openings.seed << ","
+            << openings.start;
+    }
+    return out.str();
+}
+
+std::optional<JournalState> MatchRunner::resumable_journal() const {
+    if (m_settings.journal.empty()) {
+        return std::nullopt;
+    }
+    auto state = MatchJournal::read(m_settings.journal);
+    if (!state.has_value() || state->fingerprint != fingerprint() ||
+        static_cast<int>(state->finished.size()) >= total_games()) {
+        return std::nullopt;
+    }
+    return state;
+}
+
+std::vector<MatchGame> MatchRunner::replay(const JournalState &state) {
+    // Games written to the PGN after the last journal entry are played again, the file is cut back
+    // to the journal's size below
+    if (pgn_size() > state.pgn_size && !is_match_output(m_settings.pgn_out, state.pgn_size, m_engines)) {
+        throw std::runtime_error(m_settings.pgn_out +
+                                 " has games from outside this match after the last one in the journal, the match "
+                                 "can't be resumed without losing them");
+    }
+
+    std::vector<MatchGame> unfinished;
+    for (const auto &game : state.scheduled) {
+        m_scheduled_pairs = std::max(m_scheduled_pairs, game.pair + 1);
+        if (game.id % 2 == 0) {
+            for (auto &pairing : m_pairings) {
+                if (std::minmax(pairing.engine1, pairing.engine2) == std::minmax(game.engine1, game.engine2)) {
+                    pairing.scheduled_pairs++;
+                }
+            }
+        }
+
+        const auto iter = state.finished.find(game.id);
+        if (iter == state.finished.end()) {
+            unfinished.push_back(game);
+        } else {
+            static_cast<void>(record_result(game, iter->second, true));
+        }
+    }
+    for (const auto &[engine, crashed] : state.failures) {
+        auto &failures = m_failures.at(engine);
+        (crashed ? failures.crashes : failures.hangs)++;
+    }
+    m_ratings.fit();
+
+    if (pgn_size() > state.pgn_size) {
+        std::filesystem::resize_file(m_settings.pgn_out, state.pgn_size);
+    }
+    return unfinished;
+}
+
+void MatchRunner::start(const std::string &default_fen, const std::optional<JournalState> &resume) {
+    Q_ASSERT(!is_running());
+    m_default_fen = default_fen;
+    m_scheduled_pairs = 0;
+    for (auto &pairing : m_pairings) {
+        pairing.scheduled_pairs = 0;
+    }
+    m_ratings = RatingModel(m_engines.size());
+    m_failures.assign(m_engines.size(), {});
+    m_pentanomial = {};
+    m_open_pairs.clear();
+
+    const auto unfinished = resume.has_value() ? replay(resume.value()) : std::vector<MatchGame>{};
+    if (m_settings.openings.has_value()) {
+        // The suite goes on after the openings of the earlier run
+        auto openings = m_settings.openings.value();
+        openings.start += m_scheduled_pairs;
+        m_suite = std::make_unique<OpeningSuite>(openings);
+    } else {
+        m_suite = nullptr;
+    }
+    if (!m_settings.journal.empty()) {
+        m_journal = std::make_unique<MatchJournal>(m_settings.journal, resume.has_value());
+        if (!resume.has_value()) {
+            m_journal->start(fingerprint(), pgn_size());
+        }
+    }
+    if (resume.has_value()) {
+        write_ratings();
+        emit ratings_updated();
+    }
+
+    if (!m_settings.trace.empty()) {
+        Tracer::instance().start();
+        Tracer::instance().name_thread("GUI");
+    }
+
+    m_slots.resize(std::max(1, m_settings.concurrency));
+    m_cpu_layout = {};
+    if (m_settings.pin_cpus) {
+        m_cpu_layout = plan_cpu_layout(detect_cpus(), static_cast<int>(m_slots.size()));
+        m_gui_affinity = thread_affinity();
+        // Threads started from here on, the slot threads included, inherit the GUI's CPUs
+        if (!m_cpu_layout.slot_cpus.empty() && set_thread_affinity(m_cpu_layout.gui)) {
+            std::cout << describe_cpu_layout(m_cpu_layout) << std::flush;
+        } else {
+            m_cpu_layout = {};
+            std::cout << "CPU pinning isn't supported here" << std::endl;
+        }
+    }
+    for (std::size_t i = 0; i < m_slots.size(); ++i) {
+        auto &slot = m_slots[i];
+        slot.thread = new QThread(this);
+        if (Tracer::instance().enabled()) {
+            connect(slot.thread, &QThread::started, [i]() {
+                Tracer::instance().name_thread("Slot " + std::to_string(i + 1));
+            });
+        }
+        slot.thread->start();
+        if (!m_cpu_layout.slot_cpus.empty()) {
+            slot.cpus = m_cpu_layout.slot_cpus[i];
+        }
+    }
+    for (const auto &game : unfinished) {
+        m_slots[game.pair % m_slots.size()].queue.push_back(game);
+    }
+    for (std::size_t i = 0; i < m_slots.size() && is_running(); ++i) {
+        start_game(static_cast<int>(i));
+    }
+}
+
+void MatchRunner::finish() {
+    if (m_journal) {
+        m_journal->remove();
+    }
+    stop();
+    emit match_finished();
+}
+
+void MatchRunner::stop() {
+    if (!is_running()) {
+        return;
+    }
+
+    std::vector<GameWorker *> workers;
+    for (auto &slot : m_slots) {
+        if (slot.worker != nullptr) {
+            workers.push_back(slot.worker);
+        }
+    }
+    GameWorker::stop_games(workers);
+    for (std::size_t i = 0; i < m_slots.size(); ++i) {
+        auto &slot = m_slots[i];
+        slot.thread->quit();
+        slot.thread->wait();
+        delete slot.worker;
+        delete slot.thread;
+        Metrics::instance().set_slot_busy(static_cast<int>(i), false);
+    }
+    m_slots.clear();
+    m_suite = nullptr;
+    if (!m_settings.trace.empty() && !Tracer::instance().write(m_settings.trace)) {
+        std::cout << "Could not write the trace to " << m_settings.trace << std::endl;
+    }
+    m_journal = nullptr;
+    if (!m_cpu_layout.slot_cpus.empty()) {
+        static_cast<void>(set_thread_affinity(m_gui_affinity));
+        m_cpu_layout = {};
+    }
+}
+
+double MatchRunner::uncertainty(const Pairing &pairing) const {
+    const auto s = m_ratings.score(pairing.engine1, pairing.engine2);
+    // A virtual win, draw and loss, so pairings without results start with an average variance
+    const double wins = s.wins + 1.0;
+    const double draws = s.draws + 1.0;
+    const double n = wins + draws + s.losses + 1.0;
+    const double mean = (wins + 0.5 * draws) / n;
+    const double variance = (wins + 0.25 * draws) / n - mean * mean;
+    // Standard error of the pairing's score once the games already scheduled are done
+    return std::sqrt(variance / (2.0 * pairing.scheduled_pairs + 1.0));
+}
+
+MatchRunner::Pairing *MatchRunner::next_pairing() {
+    Pairing *best = nullptr;
+    double best_uncertainty = 0.0;
+    for (auto &pairing : m_pairings) {
+        if (pairing.scheduled_pairs >= pairs_per_pairing()) {
+            continue;
+        }
+        const double u = uncertainty(pairing);
+        if (best == nullptr || u > best_uncertainty) {
+            best = &pairing;
+            best_uncertainty = u;
+        }
+    }
+    return best;
+}
+
+std::optional<MatchGame> MatchRunner::next_game(int slot_index) {
+    auto &queue = m_slots.at(slot_index).queue;
+
+    if (queue.empty()) {
+        auto busiest = std::max_element(m_slots.begin(), m_slots.end(), [](const Slot &a, const Slot &b) {
+            return a.queue.size() < b.queue.size();
+        });
+        if (!busiest->queue.empty()) {
+            queue.push_back(busiest->queue.back());
+            busiest->queue.pop_back();
+        }
+    }
+
+    // Both games of a pair go to the same slot so they are usually played one after the other
+    if (queue.empty()) {
+        if (auto *pairing = next_pairing()) {
+            const auto fen = m_suite ? m_suite->next() : m_default_fen;
+            const int pair = m_scheduled_pairs++;
+            const int a = pairing->engine1;
+            const int b = pairing->engine2;
+            pairing->scheduled_pairs++;
+            queue.push_back(MatchGame{.id = 2 * pair, .pair = pair, .fen = fen, .engine1 = a, .engine2 = b});
+            queue.push_back(MatchGame{.id = 2 * pair + 1, .pair = pair, .fen = fen, .engine1 = b, .engine2 = a});
+            if (m_journal) {
+                m_journal->scheduled(queue[queue.size() - 2]);
+                m_journal->scheduled(queue.back());
+            }
+        }
+    }
+
+    if (queue.empty()) {
+        return std::nullopt;
+    }
+    const auto game = queue.front();
+    queue.pop_front();
+    return game;
+}
+
+void MatchRunner::start_game(int slot_index) {
+    auto &slot = m_slots.at(slot_index);
+    slot.game = next_game(slot_index);
+    Metrics::instance().set(Metrics::Gauge::QueuedGames,
+                            std::accumulate(m_slots.begin(), m_slots.end(), std::int64_t{0}, [](auto n, const Slot &s) {
+                                return n + static_cast<std::int64_t>(s.queue.size());
+                            }));
+    if (!slot.game.has_value()) {
+        const bool idle = std::all_of(m_slots.begin(), m_slots.end(), [](const Slot &s) {
+            return s.worker == nullptr;
+        });
+        if (idle) {
+            finish();
+        }
+        return;
+    }
+
+    const auto game = slot.game.value();
+    auto engine1 = m_engines.at(game.engine1);
+    auto engine2 = m_engines.at(game.engine2);
+    engine1.id = 1;
+    engine2.id = 2;
+
+    auto factory = m_engine_factory;
+    if (!slot.cpus.empty()) {
+        // Engine processes inherit the affinity of the thread that starts them, the worker
+        // thread itself goes back to the GUI's CPUs afterwards. Engines inside the GUI search on
+        // the worker thread, it moves to the slot's CPUs for every search.
+        factory = [factory, cpus = slot.cpus, gui = m_cpu_layout.gui](const EngineSettings &settings) {
+            static_cast<void>(set_thread_affinity(cpus));
+            try {
+                auto engine = factory(settings);
+                static_cast<void>(set_thread_affinity(gui));
+                if (process_engine(engine.get()) == nullptr) {
+                    engine = std::make_shared<AffinityEngine>(engine, cpus, gui);
+                }
+                return engine;
+            } catch (...) {
+                static_cast<void>(set_thread_affinity(gui));
+                throw;
+            }
+        };
+    }
+
+    auto *worker = new GameWorker(AdjudicationSettings{},
+                                  m_settings.adjudication.value_or(AdjudicationRules{}),
+                                  GameSettings{.fen = game.fen, .engine1 = engine1, .engine2 = engine2},
+                                  factory,
+                                  std::chrono::milliseconds{0});
+    worker->moveToThread(slot.thread);
+    slot.worker = worker;
+    Metrics::instance().set_slot_busy(slot_index, true);
+
+    connect(
+        worker,
+        &GameWorker::new_move,
+        this,
+        [this, slot_index](GameThingy info) {
+            emit new_move(slot_index, info);
+        },
+        Qt::QueuedConnection);
+
+    connect(
+        worker,
+        &GameWorker::finished_game,
+        this,
+        [this, slot_index, worker, game](GameThingy result) {
+            if (static_cast<int>(m_slots.size()) <= slot_index || m_slots[slot_index].worker != worker) {
+                return;
+            }
+            // A hung or crashed engine loses, whatever play() made of its invalid move
+            const auto &forfeit = m_slots[slot_index].forfeit;
+            const auto outcome = forfeit.value_or(game_result(result));
+            if (forfeit.has_value()) {
+                result.result = forfeit == GameResult::BlackWin ? GameOutcome::BlackWin : GameOutcome::WhiteWin;
+            }
+            Metrics::instance().add(Metrics::Counter::GamesFinished);
+            write_pgn(game, result);
+            if (m_journal) {
+                m_journal->finished(game, outcome, pgn_size());
+            }
+            end_game(slot_index, worker);
+            const bool decided = record_result(game, outcome);
+            emit game_finished(slot_index, game, result, outcome);
+            continue_slot(slot_index, decided);
+        },
+        Qt::QueuedConnection);
+
+    connect(
+        worker,
+        &GameWorker::failed,
+        this,
+        [this, slot_index, worker, game](QString reason) {
+            if (static_cast<int>(m_slots.size()) <= slot_index || m_slots[slot_index].worker != worker) {
+                return;
+            }
+            const auto outcome = m_slots[slot_index].forfeit.value_or(GameResult::None);
+            Metrics::instance().add(Metrics::Counter::GamesFailed);
+            if (m_journal) {
+                m_journal->finished(game, outcome, pgn_size());
+            }
+            end_game(slot_index, worker);
+            const bool decided = record_result(game, outcome);
+            emit game_failed(slot_index, game, reason, outcome);
+            continue_slot(slot_index, decided);
+        },
+        Qt::QueuedConnection);
+
+    connect(
+        worker,
+        &GameWorker::engine_failed,
+        this,
+        [this, slot_index, worker, game](int engine, bool crashed) {
+            if (static_cast<int>(m_slots.size()) <= slot_index || m_slots[slot_index].worker != worker) {
+                return;
+            }
+            // engine1 plays Black
+            m_slots[slot_index].forfeit = engine == 1 ? GameResult::WhiteWin : GameResult::BlackWin;
+            const int index = engine == 1 ? game.engine1 : game.engine2;
+            auto &failures = m_failures.at(index);
+            if (crashed) {
+                failures.crashes++;
+            } else {
+                failures.hangs++;
+            }
+            Metrics::instance().add(Metrics::Counter::Forfeits);
+            Metrics::instance().add(crashed ? Metrics::Counter::EngineCrashes : Metrics::Counter::EngineHangs);
+            if (m_journal) {
+                m_journal->engine_failed(index, crashed);
+            }
+            emit engine_failed(slot_index, game, index, crashed ? "crashed" : "stopped responding");
+        },
+        Qt::QueuedConnection);
+
+    emit game_started(slot_index, game);
+    QMetaObject::invokeMethod(worker, "start_game", Qt::QueuedConnection);
+}
+
+void MatchRunner::end_game(int slot_index, GameWorker *worker) {
+    auto &slot = m_slots.at(slot_index);
+    Q_ASSERT(slot.worker == worker);
+    worker->deleteLater();
+    slot.worker = nullptr;
+    Metrics::instance().set_slot_busy(slot_index, false);
+    slot.game = std::nullopt;
+    slot.forfeit = std::nullopt;
+}
+
+void MatchRunner::continue_slot(int slot_index, bool decided) {
+    if (decided) {
+        // Games still running can't change the outcome anymore
+        finish();
+    } else if (is_running()) {
+        start_game(slot_index);
+    }
+}
+
+void MatchRunner::write_pgn(const MatchGame &game, const GameThingy &result) const {
+    if (m_settings.pgn_out.empty()) {
+        return;
+    }
+    const TraceSpan span("pgn", "match");
+    std::ofstream file(m_settings.pgn_out, std::ios::app);
+    file << get_pgn(PGNSettings{}, m_engines.at(game.engine1).name, m_engines.at(game.engine2).name, result) << "\n\n";
+}
+
+std::uint64_t MatchRunner::pgn_size() const {
+    std::error_code ec;
+    const auto size = m_settings.pgn_out.empty() ? 0 : std::filesystem::file_size(m_settings.pgn_out, ec);
+    return ec ? 0 : size;
+}
+
+void MatchRunner::write_ratings() const {
+    if (m_settings.ratings_out.empty()) {
+        return;
+    }
+    std::vector<std::string> names;
+    for (const auto &engine : m_engines) {
+        names.push_back(engine.name);
+    }
+    std::ofstream file(m_settings.ratings_out);
+    write_rating_table(file, names, m_ratings);
+
+    bool header = false;
+    for (std::size_t i = 0; i < m_failures.size(); ++i) {
+        const auto &failures = m_failures[i];
+        if (failures.hangs + failures.crashes == 0) {
+            continue;
+        }
+        if (!header) {
+            file << "\nEngine failures\n";
+            header = true;
+        }
+        file << names[i] << ": " << failures.hangs << " hangs, " << failures.crashes << " crashes\n";
+    }
+}
+
+bool MatchRunner::record_result(const MatchGame &game, GameResult result, bool replay) {
+    const double points = result == GameResult::None ? std::nan("")
+                          : game.engine1 == 0        ? black_points(result)
+                                                     : 1.0 - black_points(result);
+
+    if (result != GameResult::None) {
+        m_ratings.add_result(game.engine1, game.engine2, black_points(result), !replay);
+        if (!replay) {
+            write_ratings();
+            emit ratings_updated();
+        }
+    }
+
+    const auto iter = m_open_pairs.find(game.pair);
+    if (iter == m_open_pairs.end()) {
+        m_open_pairs.emplace(game.pair, points);
+        return false;
+    }
+    const double pair_points = iter->second + points;
+    m_open_pairs.erase(iter);
+
+    // A pair with a failed game says nothing about the engines, it's left out
+    if (std::isnan(pair_points) || m_engines.size() != 2) {
+        return false;
+    }
+    m_pentanomial.add(pair_points);
+
+    if (!m_sprt.has_value() || replay) {
+        return false;
+    }
+    emit sprt_updated(m_sprt->llr(m_pentanomial));
+    return m_sprt->result(m_pentanomial) != SprtResult::Continue;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <QObject>
+#include <QThread>
+#include <deque>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "../gameworker.hpp"
+#include "../openings/openingsuite.hpp"
+#include "cpuaffinity.hpp"
+#include "gameresult.hpp"
+#include "journal.hpp"
+#include "matchgame.hpp"
+#include "matchsettings.hpp"
+#include "ratings.hpp"
+#include "sprt.hpp"
+
+// Plays a match or tournament on several concurrency slots, each slot with its own thread.
+// Lives on the GUI thread; the games themselves run in GameWorkers on the slot threads.
+// New pairs go to the pairing whose score is least certain. A slot queues the reversed game of its
+// pair, and a slot without work takes that game from the slot with the longest queue, so no slot
+// waits for another slot's long game.
+class MatchRunner : public QObject {
+    Q_OBJECT
+
+   public:
+    MatchRunner(const MatchSettings &settings,
+                std::vector<EngineSettings> engines,
+                GameWorker::EngineFactory engine_factory,
+                QObject *parent = nullptr);
+    ~MatchRunner();
+
+    // default_fen is used for every pair when there is no opening suite. With a journal state the
+    // match continues where it stopped, games that finished aren't played again.
+    void start(const std::string &default_fen, const std::optional<JournalState> &resume = std::nullopt);
+    void stop();
+
+    [[nodiscard]] bool is_running() const {
+        return !m_slots.empty();
+    }
+
+    [[nodiscard]] const std::vector<EngineSettings> &engines() const {
+        return m_engines;
+    }
+
+    [[nodiscard]] int total_games() const;
+
+    // The journal of an earlier run of this match if it has games left to play
+    [[nodiscard]] std::optional<JournalState> resumable_journal() const;
+
+    // Finished pairs, from the point of view of the first engine
+    [[nodiscard]] const Pentanomial &pentanomial() const {
+        return m_pentanomial;
+    }
+
+    // Only set when the match runs an SPRT
+    [[nodiscard]] const std::optional<Sprt> &sprt() const {
+        return m_sprt;
+    }
+
+    [[nodiscard]] const RatingModel &ratings() const {
+        return m_ratings;
+    }
+
+    struct EngineFailures {
+        int hangs = 0;
+        int crashes = 0;
+    };
+
+    [[nodiscard]] const std::vector<EngineFailures> &failures() const {
+        return m_failures;
+    }
+
+    [[nodiscard]] SprtResult sprt_result() const {
+        return m_sprt.has_value() ? m_sprt->result(m_pentanomial) : SprtResult::Continue;
+    }
+
+   signals:
+    void game_started(int slot, MatchGame game);
+    void new_move(int slot, GameThingy info);
+    // outcome is what the match counts, a hung or crashed engine loses whatever play() made of it
+    void game_finished(int slot, MatchGame game, GameThingy result, GameResult outcome);
+    void game_failed(int slot, MatchGame game, QString reason, GameResult outcome);
+    // engine is an index into engines(), the engine lost the game
+    void engine_failed(int slot, MatchGame game, int engine, QString reason);
+    void sprt_updated(double llr);
+    void ratings_updated();
+    void match_finished();
+
+   private:
+    struct Slot {
+        QThread *thread = nullptr;
+        GameWorker *worker = nullptr;
+        std::optional<MatchGame> game;
+        std::deque<MatchGame> queue;
+        // Engine processes of the slot run on these, any CPU if empty
+        std::vector<int> cpus;
+        // Result of the current game if an engine hung or crashed
+        std::optional<GameResult> forfeit;
+    };
+
+    struct Pairing {
+        int engine1 = 0;
+        int engine2 = 1;
+        int scheduled_pairs = 0;
+    };
+
+    [[nodiscard]] int pairs_per_pairing() const;
+    [[nodiscard]] double uncertainty(const Pairing &pairing) const;
+    [[nodiscard]] Pairing *next_pairing();
+    [[nodiscard]] std::optional<MatchGame> next_game(int slot);
+    void start_game(int slot);
+    void end_game(int slot, GameWorker *worker);
+    // Starts the slot's next game, or ends the match once the SPRT has decided
+    void continue_slot(int slot, bool decided);
+    void write_pgn(const MatchGame &game, const GameThingy &result) const;
+    [[nodiscard]] std::uint64_t pgn_size() const;
+    void write_ratings() const;
+    // Returns true once the SPRT has come to a result. Replayed results from a journal are only counted.
+    [[nodiscard]] bool record_result(const MatchGame &game, GameResult result, bool replay = false);
+    // Restores the state of an earlier run, returns the games it didn't finish
+    [[nodiscard]] std::vector<MatchGame> replay(const JournalState &state);
+    [[nodiscard]] std::string fingerprint() const;
+    // Match is complete, or decided by the SPRT
+    void finish();
+
+    MatchSettings m_settings;
+    std::vector<EngineSettings> m_engines;
+    GameWorker::EngineFactory m_engine_factory;
+    std::unique_ptr<OpeningSuite> m_suite;
+    std::unique_ptr<MatchJournal> m_journal;
+    std::string m_default_fen;
+    std::vector<Slot> m_slots;
+    CpuLayout m_cpu_layout;
+    // GUI thread affinity from before the match
+    std::vector<int> m_gui_affinity;
+    std::vector<Pairing> m_pairings;
+    int m_scheduled_pairs = 0;
+    RatingModel m_ratings;
+    std::vector<EngineFailures> m_failures;
+    std::optional<Sprt> m_sprt;
+    Pentanomial m_pentanomial;
+    // Points of the first engine in pairs with one game finished, NaN if that game failed
+    std::map<int, double> m_open_pairs;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+#include "../adjudication/adjudicator.hpp"
+#include "../openings/openingsuite.hpp"
+#include "resourceplanner.hpp"
+#include "sprt.hpp"
+
+struct MatchSettings {
+    enum class Format
+    {
+        RoundRobin,
+        // The first engine plays all the others
+        Gauntlet,
+    };
+
+    Format format = Format::RoundRobin;
+    // Engine names from the settings file, the two engines selected in the window if empty
+    std::vector<std::string> engines;
+    // Games per pairing, rounded up to whole pairs. Every opening is played twice with colours reversed
+    int games = 100;
+    // Games played at the same time
+    int concurrency = 1;
+    // How threads and hash of the engines are fitted to the concurrency
+    ResourceSettings resources;
+    // Pin the engines of every slot to cores of their own, Linux only
+    bool pin_cpus = false;
+    // Without a suite every pair starts from the position on the board
+    std::optional<OpeningSuiteSettings> openings;
+    // Finished games are appended here
+    std::string pgn_out;
+    // Rating list and crosstable, rewritten after every game
+    std::string ratings_out;
+    // Log of the match to resume it after a crash, deleted once the match is complete
+    std::string journal;
+    // Chrome trace of the match, written when it ends
+    std::string trace;
+    // Stops the match as soon as one hypothesis is accepted, games is still the upper limit.
+    // Only used for matches between two engines
+    std::optional<SprtSettings> sprt;
+    // The match's own rules, otherwise the ones for all games
+    std::optional<AdjudicationRules> adjudication;
+};
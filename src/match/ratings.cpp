@@ -0,0 +1,213 @@
+#include "ratings.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+
+namespace {
+
+// Virtual draws between every pair of players that met, keeps the ratings of players without
+// wins or without losses finite
+constexpr double prior_draws = 2.0;
+constexpr int max_iterations = 1000;
+constexpr double tolerance = 1e-7;
+
+double elo_to_gamma(double elo) {
+    return std::pow(10.0, elo / 400.0);
+}
+
+double gamma_to_elo(double gamma) {
+    return 400.0 * std::log10(gamma);
+}
+
+}  // namespace
+
+RatingModel::RatingModel(std::size_t players)
+    : m_players(players), m_scores(players * players), m_gammas(players, 1.0), m_theta(elo_to_gamma(97.3)) {
+}
+
+void RatingModel::add_result(std::size_t player, std::size_t opponent, double points, bool refit) {
+    auto &score = m_scores[player * m_players + opponent];
+    auto &reverse = m_scores[opponent * m_players + player];
+    if (points > 0.75) {
+        score.wins++;
+        reverse.losses++;
+    } else if (points > 0.25) {
+        score.draws++;
+        reverse.draws++;
+    } else {
+        score.losses++;
+        reverse.wins++;
+    }
+    if (refit) {
+        fit();
+    }
+}
+
+double RatingModel::draw_elo() const {
+    return gamma_to_elo(m_theta);
+}
+
+double RatingModel::log_likelihood(const std::vector<double> &gammas, double theta) const {
+    double result = 0.0;
+    for (std::size_t i = 0; i < m_players; ++i) {
+        for (std::size_t j = i + 1; j < m_players; ++j) {
+            const auto &s = score(i, j);
+            if (s.wins + s.draws + s.losses == 0) {
+                continue;
+            }
+            const double gi = gammas[i];
+            const double gj = gammas[j];
+            const double draws = s.draws + prior_draws;
+            result += s.wins * std::log(gi / (gi + theta * gj));
+            result += s.losses * std::log(gj / (gj + theta * gi));
+            result += draws * std::log((theta * theta - 1.0) * gi * gj / ((gi + theta * gj) * (gj + theta * gi)));
+        }
+    }
+    return result;
+}
+
+double RatingModel::theta_derivative(double theta) const {
+    double result = 0.0;
+    for (std::size_t i = 0; i < m_players; ++i) {
+        for (std::size_t j = i + 1; j < m_players; ++j) {
+            const auto &s = score(i, j);
+            if (s.wins + s.draws + s.losses == 0) {
+                continue;
+            }
+            const double gi = m_gammas[i];
+            const double gj = m_gammas[j];
+            const double draws = s.draws + prior_draws;
+            const double a = gj / (gi + theta * gj);
+            const double b = gi / (gj + theta * gi);
+            result += -s.wins * a - s.losses * b + draws * (2.0 * theta / (theta * theta - 1.0) - a - b);
+        }
+    }
+    return result;
+}
+
+void RatingModel::fit() {
+    std::vector<double> next(m_players);
+    for (int iteration = 0; iteration < max_iterations; ++iteration) {
+        // Minorization-maximization step for every rating (Hunter 2004)
+        double change = 0.0;
+        for (std::size_t i = 0; i < m_players; ++i) {
+            double numerator = 0.0;
+            double denominator = 0.0;
+            for (std::size_t j = 0; j < m_players; ++j) {
+                const auto &s = score(i, j);
+                if (i == j || s.wins + s.draws + s.losses == 0) {
+                    continue;
+                }
+                const double draws = s.draws + prior_draws;
+                numerator += s.wins + draws;
+                denominator += (s.wins + draws) / (m_gammas[i] + m_theta * m_gammas[j]);
+                denominator += m_theta * (s.losses + draws) / (m_theta * m_gammas[i] + m_gammas[j]);
+            }
+            next[i] = denominator > 0.0 ? numerator / denominator : m_gammas[i];
+        }
+
+        // Average rating 0
+        double log_mean = 0.0;
+        for (const auto gamma : next) {
+            log_mean += std::log(gamma);
+        }
+        const double scale = std::exp(-log_mean / static_cast<double>(m_players));
+        for (std::size_t i = 0; i < m_players; ++i) {
+            next[i] *= scale;
+            change = std::max(change, std::abs(next[i] - m_gammas[i]) / m_gammas[i]);
+        }
+        m_gammas.swap(next);
+
+        // The likelihood has a single maximum in theta, found by bisection on the derivative
+        double low = 1.0 + 1e-9;
+        double high = 1e4;
+        for (int step = 0; step < 60; ++step) {
+            const double mid = std::sqrt(low * high);
+            if (theta_derivative(mid) > 0.0) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        const double theta = std::sqrt(low * high);
+        change = std::max(change, std::abs(theta - m_theta) / m_theta);
+        m_theta = theta;
+
+        if (change < tolerance) {
+            break;
+        }
+    }
+}
+
+std::vector<Rating> RatingModel::ratings() const {
+    std::vector<Rating> result(m_players);
+    for (std::size_t i = 0; i < m_players; ++i) {
+        auto &rating = result[i];
+        rating.elo = gamma_to_elo(m_gammas[i]);
+        for (std::size_t j = 0; j < m_players; ++j) {
+            const auto &s = score(i, j);
+            rating.games += s.wins + s.draws + s.losses;
+            rating.points += s.wins + 0.5 * s.draws;
+        }
+        if (rating.games == 0) {
+            continue;
+        }
+
+        // Curvature of the likelihood in this rating with the others fixed
+        constexpr double h = 1.0;
+        auto gammas = m_gammas;
+        const double center = log_likelihood(gammas, m_theta);
+        gammas[i] = elo_to_gamma(rating.elo + h);
+        const double up = log_likelihood(gammas, m_theta);
+        gammas[i] = elo_to_gamma(rating.elo - h);
+        const double down = log_likelihood(gammas, m_theta);
+        const double curvature = (up - 2.0 * center + down) / (h * h);
+        rating.error = curvature < 0.0 ? 1.96 / std::sqrt(-curvature) : 0.0;
+    }
+    return result;
+}
+
+void write_rating_table(std::ostream &out, const std::vector<std::string> &names, const RatingModel &model) {
+    const auto ratings = model.ratings();
+    std::vector<std::size_t> order(ratings.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&ratings](std::size_t a, std::size_t b) {
+        return ratings[a].elo > ratings[b].elo;
+    });
+
+    std::size_t width = 4;
+    for (const auto &name : names) {
+        width = std::max(width, name.size());
+    }
+
+    out << std::fixed;
+    out << "Rank " << std::left << std::setw(static_cast<int>(width)) << "Name" << std::right << "    Elo     +/-  Games  Score\n";
+    for (std::size_t rank = 0; rank < order.size(); ++rank) {
+        const auto &r = ratings[order[rank]];
+        const double score = r.games > 0 ? 100.0 * r.points / r.games : 0.0;
+        out << std::setw(4) << rank + 1 << " " << std::left << std::setw(static_cast<int>(width)) << names[order[rank]]
+            << std::right << std::setw(7) << std::setprecision(1) << r.elo << std::setw(8) << r.error << std::setw(7)
+            << r.games << std::setw(6) << score << "%\n";
+    }
+    out << "Draw Elo " << std::setprecision(1) << model.draw_elo() << "\n\n";
+
+    // Crosstable, wins-draws-losses of the row against the column
+    out << std::left << std::setw(static_cast<int>(width)) << "";
+    for (std::size_t col = 0; col < order.size(); ++col) {
+        out << std::right << std::setw(16) << col + 1;
+    }
+    out << "\n";
+    for (std::size_t row = 0; row < order.size(); ++row) {
+        out << std::left << std::setw(static_cast<int>(width)) << names[order[row]] << std::right;
+        for (std::size_t col = 0; col < order.size(); ++col) {
+            if (row == col) {
+                out << std::setw(16) << "-";
+                continue;
+            }
+            const auto s = model.score(order[row], order[col]);
+            out << std::setw(16) << (std::to_string(s.wins) + "-" + std::to_string(s.draws) + "-" + std::to_string(s.losses));
+        }
+        out << "\n";
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct Rating {
+    double elo = 0.0;
+    // Half width of the 95% confidence interval
+    double error = 0.0;
+    int games = 0;
+    double points = 0.0;
+};
+
+// Maximum likelihood ratings in the BayesElo model, where a draw is a result of its own whose
+// probability grows with the draw Elo. The fit is refined after every result starting from the
+// previous solution, so it only takes a few iterations once a match is under way.
+// Colour advantage isn't modelled, matches play every opening with both colours.
+class RatingModel {
+   public:
+    struct Score {
+        int wins = 0;
+        int draws = 0;
+        int losses = 0;
+    };
+
+    explicit RatingModel(std::size_t players);
+
+    // points is 1, 0.5 or 0 for player. Loading many results is faster without refitting after each.
+    void add_result(std::size_t player, std::size_t opponent, double points, bool refit = true);
+    void fit();
+
+    // Average rating is 0
+    [[nodiscard]] std::vector<Rating> ratings() const;
+
+    [[nodiscard]] Score score(std::size_t player, std::size_t opponent) const {
+        return m_scores[player * m_players + opponent];
+    }
+
+    [[nodiscard]] double draw_elo() const;
+
+    [[nodiscard]] std::size_t players() const {
+        return m_players;
+    }
+
+   private:
+    [[nodiscard]] double log_likelihood(const std::vector<double> &gammas, double theta) const;
+    [[nodiscard]] double theta_derivative(double theta) const;
+
+    std::size_t m_players;
+    std::vector<Score> m_scores;
+    // Ratings as 10^(elo / 400)
+    std::vector<double> m_gammas;
+    // Draw Elo as 10^(draw_elo / 400)
+    double m_theta;
+};
+
+// Rating list followed by the crosstable
+void write_rating_table(std::ostream &out, const std::vector<std::string> &names, const RatingModel &model);
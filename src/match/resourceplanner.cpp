@@ -0,0 +1,139 @@
+#include "resourceplanner.hpp"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+bool is_option(const std::string &name, const std::string &wanted) {
+    return std::equal(name.begin(), name.end(), wanted.begin(), wanted.end(), [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) == b;
+    });
+}
+
+// Engines without the option are assumed to use 1 thread and no hash worth counting
+std::uint64_t get_option(const EngineSettings &engine, const std::string &name, std::uint64_t fallback) {
+    for (const auto &[key, value] : engine.options) {
+        if (is_option(key, name)) {
+            try {
+                return std::stoull(value);
+            } catch (const std::exception &) {
+                return fallback;
+            }
+        }
+    }
+    return fallback;
+}
+
+bool has_option(const EngineSettings &engine, const std::string &name) {
+    return std::any_of(engine.options.begin(), engine.options.end(), [&name](const auto &option) {
+        return is_option(option.first, name);
+    });
+}
+
+void set_option(EngineSettings &engine, const std::string &name, std::uint64_t value) {
+    for (auto &[key, val] : engine.options) {
+        if (is_option(key, name)) {
+            val = std::to_string(value);
+        }
+    }
+}
+
+}  // namespace
+
+HostResources detect_host_resources() {
+    HostResources host;
+    host.cores = std::max(1u, std::thread::hardware_concurrency());
+#ifdef _WIN32
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status)) {
+        host.memory_mb = status.ullTotalPhys / (1024 * 1024);
+    }
+#else
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long page_size = sysconf(_SC_PAGE_SIZE);
+    if (pages > 0 && page_size > 0) {
+        host.memory_mb = static_cast<std::uint64_t>(pages) * static_cast<std::uint64_t>(page_size) / (1024 * 1024);
+    }
+#endif
+    return host;
+}
+
+ResourcePlan plan_resources(const std::vector<EngineSettings> &engines,
+                            int concurrency,
+                            const ResourceSettings &settings) {
+    ResourcePlan plan;
+    plan.host = detect_host_resources();
+    if (settings.cores > 0) {
+        plan.host.cores = settings.cores;
+    }
+    if (settings.memory_mb > 0) {
+        plan.host.memory_mb = settings.memory_mb;
+    }
+    plan.engines = engines;
+
+    const auto games = static_cast<std::uint64_t>(std::max(1, concurrency));
+    if (games > plan.host.cores) {
+        throw std::runtime_error("Concurrency " + std::to_string(games) + " is more than the " +
+                                 std::to_string(plan.host.cores) + " cores of this machine");
+    }
+    const std::uint64_t threads_per_game = plan.host.cores / games;
+    // Unknown memory, e.g. an unsupported platform, isn't checked
+    const std::uint64_t usable_mb =
+        plan.host.memory_mb > settings.reserve_mb ? plan.host.memory_mb - settings.reserve_mb : 0;
+    const std::uint64_t hash_per_engine = usable_mb / (2 * games);
+
+    std::ostringstream report;
+    report << "Host: " << plan.host.cores << " cores, " << plan.host.memory_mb << " MB\n";
+    report << "Concurrency " << games << ": up to " << threads_per_game << " threads and " << hash_per_engine
+           << " MB hash per engine\n";
+
+    for (auto &engine : plan.engines) {
+        auto threads = get_option(engine, "threads", 1);
+        auto hash = get_option(engine, "hash", 0);
+
+        if (settings.automatic) {
+            threads = std::clamp<std::uint64_t>(threads, 1, threads_per_game);
+            // A configured hash of 0 is kept, only a hash the clamp takes away is an error
+            const bool wants_hash = hash > 0;
+            if (plan.host.memory_mb > 0) {
+                hash = std::min(hash, hash_per_engine);
+            }
+            if (has_option(engine, "threads")) {
+                set_option(engine, "threads", threads);
+            }
+            if (has_option(engine, "hash")) {
+                if (wants_hash && hash == 0) {
+                    throw std::runtime_error("Not enough memory for the hash of " + std::to_string(2 * games) +
+                                             " engines");
+                }
+                set_option(engine, "hash", hash);
+            }
+        }
+
+        if (threads > threads_per_game) {
+            throw std::runtime_error(engine.name + " uses " + std::to_string(threads) + " threads, " +
+                                     std::to_string(games) + " games at once leave " +
+                                     std::to_string(threads_per_game) + " per game");
+        }
+        if (plan.host.memory_mb > 0 && hash > hash_per_engine) {
+            throw std::runtime_error(engine.name + " uses " + std::to_string(hash) + " MB hash, " +
+                                     std::to_string(games) + " games at once leave " + std::to_string(hash_per_engine) +
+                                     " MB per engine");
+        }
+        report << engine.name << ": threads " << threads << ", hash " << hash << " MB\n";
+    }
+
+    plan.report = report.str();
+    return plan;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <../core/engine/settings.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct HostResources {
+    unsigned cores = 1;
+    std::uint64_t memory_mb = 0;
+};
+
+struct ResourceSettings {
+    // Lower every engine's "threads" and "hash" options until the match fits the host,
+    // otherwise the options are used as they are and only checked
+    bool automatic = true;
+    // Override the detected host, 0 to detect
+    unsigned cores = 0;
+    std::uint64_t memory_mb = 0;
+    // Memory kept free for the system and the GUI
+    std::uint64_t reserve_mb = 1024;
+};
+
+struct ResourcePlan {
+    HostResources host;
+    // The engines with their planned options
+    std::vector<EngineSettings> engines;
+    std::string report;
+};
+
+[[nodiscard]] HostResources detect_host_resources();
+
+// Sizes threads and hash of every engine for concurrency games at once. Only the side to move
+// thinks, so a game needs the threads of its bigger engine but the hash of both.
+// Throws std::runtime_error if the match can't run without oversubscribing the host.
+[[nodiscard]] ResourcePlan plan_resources(const std::vector<EngineSettings> &engines,
+                                          int concurrency,
+                                          const ResourceSettings &settings);
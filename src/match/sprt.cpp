@@ -0,0 +1,75 @@
+#include "sprt.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+double elo_to_score(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+}  // namespace
+
+void Pentanomial::add(double pair_points) {
+    const auto index = static_cast<std::size_t>(std::lround(pair_points * 2.0));
+    counts.at(std::min<std::size_t>(index, counts.size() - 1))++;
+}
+
+std::uint64_t Pentanomial::pairs() const {
+    return std::accumulate(counts.begin(), counts.end(), std::uint64_t{0});
+}
+
+Sprt::Sprt(const SprtSettings &settings)
+    : m_score0(elo_to_score(settings.elo0)),
+      m_score1(elo_to_score(settings.elo1)),
+      m_lower(std::log(settings.beta / (1.0 - settings.alpha))),
+      m_upper(std::log((1.0 - settings.beta) / settings.alpha)) {
+    if (settings.alpha <= 0.0 || settings.alpha >= 1.0 || settings.beta <= 0.0 || settings.beta >= 1.0) {
+        throw std::invalid_argument("SPRT alpha and beta have to be between 0 and 1");
+    }
+    if (settings.elo0 >= settings.elo1) {
+        throw std::invalid_argument("SPRT elo0 has to be less than elo1");
+    }
+}
+
+double Sprt::llr(const Pentanomial &pentanomial) const {
+    const auto pairs = pentanomial.pairs();
+    if (pairs == 0) {
+        return 0.0;
+    }
+
+    // A small prior keeps the variance above zero for the first few pairs
+    constexpr double prior = 1e-3;
+    double total = 0.0;
+    std::array<double, 5> frequencies{};
+    for (std::size_t i = 0; i < frequencies.size(); ++i) {
+        frequencies[i] = static_cast<double>(pentanomial.counts[i]) + prior;
+        total += frequencies[i];
+    }
+
+    // Pair scores scaled to [0, 1]
+    double mean = 0.0;
+    for (std::size_t i = 0; i < frequencies.size(); ++i) {
+        frequencies[i] /= total;
+        mean += frequencies[i] * static_cast<double>(i) / 4.0;
+    }
+    double variance = 0.0;
+    for (std::size_t i = 0; i < frequencies.size(); ++i) {
+        const double diff = static_cast<double>(i) / 4.0 - mean;
+        variance += frequencies[i] * diff * diff;
+    }
+
+    return static_cast<double>(pairs) * (m_score1 - m_score0) * (2.0 * mean - m_score0 - m_score1) / (2.0 * variance);
+}
+
+SprtResult Sprt::result(const Pentanomial &pentanomial) const {
+    const double value = llr(pentanomial);
+    if (value >= m_upper) {
+        return SprtResult::AcceptH1;
+    } else if (value <= m_lower) {
+        return SprtResult::AcceptH0;
+    }
+    return SprtResult::Continue;
+}
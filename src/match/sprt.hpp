@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+struct SprtSettings {
+    // Logistic Elo of H0 and H1
+    double elo0 = 0.0;
+    double elo1 = 5.0;
+    double alpha = 0.05;
+    double beta = 0.05;
+};
+
+enum class SprtResult
+{
+    Continue,
+    AcceptH0,
+    AcceptH1,
+};
+
+// Results of colour-reversed game pairs, counted by the first engine's points in the pair:
+// 0, 0.5, 1, 1.5 and 2
+struct Pentanomial {
+    std::array<std::uint64_t, 5> counts{};
+
+    void add(double pair_points);
+
+    [[nodiscard]] std::uint64_t pairs() const;
+};
+
+// Generalized SPRT on the pentanomial distribution, with the normal approximation used by fishtest.
+// Pairs are scored instead of single games, so a correlated opening doesn't make results look
+// more certain than they are.
+class Sprt {
+   public:
+    explicit Sprt(const SprtSettings &settings);
+
+    [[nodiscard]] double llr(const Pentanomial &pentanomial) const;
+    [[nodiscard]] SprtResult result(const Pentanomial &pentanomial) const;
+
+    [[nodiscard]] double lower_bound() const {
+        return m_lower;
+    }
+
+    [[nodiscard]] double upper_bound() const {
+        return m_upper;
+    }
+
+   private:
+    double m_score0;
+    double m_score1;
+    double m_lower;
+    double m_upper;
+};
@@ -0,0 +1,180 @@
+#include "metrics.hpp"
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+struct CounterInfo {
+    const char *name;
+    const char *help;
+};
+
+// In the order of Metrics::Counter
+constexpr std::array<CounterInfo, Metrics::num_counters> counter_info = {{
+    {"ataxx_games_finished_total", "Match games played to the end."},
+    {"ataxx_games_failed_total", "Match games that couldn't be played to the end."},
+    {"ataxx_forfeits_total", "Games lost because an engine hung or crashed."},
+    {"ataxx_engine_crashes_total", "Engines that crashed during a game."},
+    {"ataxx_engine_hangs_total", "Engines that stopped responding during a game."},
+    {"ataxx_moves_total", "Moves played in games."},
+    {"ataxx_datagen_games_total", "Self-play games finished by datagen."},
+    {"ataxx_datagen_positions_total", "Training positions written by datagen."},
+}};
+
+// In the order of Metrics::Gauge
+constexpr std::array<CounterInfo, Metrics::num_gauges> gauge_info = {{
+    {"ataxx_queued_games", "Games queued on the match slots."},
+    {"ataxx_datagen_writer_queue", "Games waiting for the datagen writer."},
+}};
+
+void write_header(std::ostringstream &out, const char *name, const char *help, const char *type) {
+    out << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n";
+}
+
+template <std::size_t N, typename Buckets>
+void write_histogram(std::ostringstream &out,
+                     const char *name,
+                     const char *help,
+                     const std::array<double, N> &bounds,
+                     const Buckets &counts,
+                     std::uint64_t sum) {
+    write_header(out, name, help, "histogram");
+    std::uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+        cumulative += counts[i];
+        // The bounds are whole numbers, written without an exponent
+        out << name << "_bucket{le=\"" << static_cast<std::int64_t>(bounds[i]) << "\"} " << cumulative << "\n";
+    }
+    cumulative += counts[N];
+    out << name << "_bucket{le=\"+Inf\"} " << cumulative << "\n";
+    out << name << "_sum " << sum << "\n";
+    out << name << "_count " << cumulative << "\n";
+}
+
+template <std::size_t N>
+std::size_t bucket_index(const std::array<double, N> &bounds, double value) {
+    return static_cast<std::size_t>(std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin());
+}
+
+}  // namespace
+
+Metrics &Metrics::instance() {
+    static Metrics metrics;
+    return metrics;
+}
+
+Metrics::Metrics() : m_start(Clock::now()) {
+}
+
+Metrics::Shard &Metrics::shard() {
+    thread_local Shard *own = nullptr;
+    if (own == nullptr) {
+        std::lock_guard lock(m_mutex);
+        m_shards.push_back(std::make_unique<Shard>());
+        own = m_shards.back().get();
+    }
+    return *own;
+}
+
+std::int64_t Metrics::now() const {
+    // Never 0, which marks an idle slot
+    return (Clock::now() - m_start).count() + 1;
+}
+
+void Metrics::add(Counter counter, std::uint64_t n) {
+    shard().counters[static_cast<std::size_t>(counter)].fetch_add(n, std::memory_order_relaxed);
+}
+
+void Metrics::set(Gauge gauge, std::int64_t value) {
+    m_gauges[static_cast<std::size_t>(gauge)].store(value, std::memory_order_relaxed);
+}
+
+void Metrics::observe_search(std::optional<int> depth, std::optional<std::int64_t> nps) {
+    auto &own = shard();
+    if (depth.has_value()) {
+        own.depth.buckets[bucket_index(depth_buckets, depth.value())].fetch_add(1, std::memory_order_relaxed);
+        own.depth.sum.fetch_add(static_cast<std::uint64_t>(std::max(0, depth.value())), std::memory_order_relaxed);
+    }
+    if (nps.has_value()) {
+        own.nps.buckets[bucket_index(nps_buckets, static_cast<double>(nps.value()))].fetch_add(
+            1, std::memory_order_relaxed);
+        own.nps.sum.fetch_add(static_cast<std::uint64_t>(std::max<std::int64_t>(0, nps.value())),
+                              std::memory_order_relaxed);
+    }
+}
+
+void Metrics::set_slot_busy(int slot, bool busy) {
+    if (slot < 0 || slot >= max_slots) {
+        return;
+    }
+    int slots = m_num_slots.load(std::memory_order_relaxed);
+    while (slots <= slot && !m_num_slots.compare_exchange_weak(slots, slot + 1, std::memory_order_relaxed)) {
+    }
+
+    auto &s = m_slots[slot];
+    if (busy) {
+        std::int64_t idle = 0;
+        s.busy_since.compare_exchange_strong(idle, now(), std::memory_order_relaxed);
+    } else if (const auto since = s.busy_since.exchange(0, std::memory_order_relaxed); since != 0) {
+        s.busy_total.fetch_add(now() - since, std::memory_order_relaxed);
+    }
+}
+
+std::string Metrics::scrape() const {
+    std::array<std::uint64_t, num_counters> counters{};
+    std::array<std::uint64_t, depth_buckets.size() + 1> depth{};
+    std::array<std::uint64_t, nps_buckets.size() + 1> nps{};
+    std::uint64_t depth_sum = 0;
+    std::uint64_t nps_sum = 0;
+    {
+        std::lock_guard lock(m_mutex);
+        for (const auto &shard : m_shards) {
+            for (std::size_t i = 0; i < num_counters; ++i) {
+                counters[i] += shard->counters[i].load(std::memory_order_relaxed);
+            }
+            for (std::size_t i = 0; i < depth.size(); ++i) {
+                depth[i] += shard->depth.buckets[i].load(std::memory_order_relaxed);
+            }
+            for (std::size_t i = 0; i < nps.size(); ++i) {
+                nps[i] += shard->nps.buckets[i].load(std::memory_order_relaxed);
+            }
+            depth_sum += shard->depth.sum.load(std::memory_order_relaxed);
+            nps_sum += shard->nps.sum.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::ostringstream out;
+    for (std::size_t i = 0; i < num_counters; ++i) {
+        write_header(out, counter_info[i].name, counter_info[i].help, "counter");
+        out << counter_info[i].name << " " << counters[i] << "\n";
+    }
+    for (std::size_t i = 0; i < num_gauges; ++i) {
+        write_header(out, gauge_info[i].name, gauge_info[i].help, "gauge");
+        out << gauge_info[i].name << " " << m_gauges[i].load(std::memory_order_relaxed) << "\n";
+    }
+
+    const auto elapsed = now();
+    const double hours = std::chrono::duration<double, std::ratio<3600>>(Clock::duration(elapsed)).count();
+    const auto finished = counters[static_cast<std::size_t>(Counter::GamesFinished)] +
+                          counters[static_cast<std::size_t>(Counter::DatagenGames)];
+    write_header(out, "ataxx_games_per_hour", "Games finished per hour since the start.", "gauge");
+    out << "ataxx_games_per_hour " << (hours > 0.0 ? static_cast<double>(finished) / hours : 0.0) << "\n";
+    write_header(out, "ataxx_uptime_seconds", "Seconds since the start.", "gauge");
+    out << "ataxx_uptime_seconds " << hours * 3600.0 << "\n";
+
+    write_histogram(out, "ataxx_search_depth", "Depth of the engines' searches.", depth_buckets, depth, depth_sum);
+    write_histogram(out, "ataxx_search_nps", "Speed of the engines' searches.", nps_buckets, nps, nps_sum);
+
+    write_header(out, "ataxx_slot_utilisation", "Share of the time since the start a slot spent playing.", "gauge");
+    const int slots = m_num_slots.load(std::memory_order_relaxed);
+    for (int i = 0; i < slots; ++i) {
+        const auto &s = m_slots[i];
+        auto busy = s.busy_total.load(std::memory_order_relaxed);
+        if (const auto since = s.busy_since.load(std::memory_order_relaxed); since != 0) {
+            busy += elapsed - since;
+        }
+        out << "ataxx_slot_utilisation{slot=\"" << i + 1 << "\"} "
+            << static_cast<double>(busy) / static_cast<double>(elapsed) << "\n";
+    }
+    return out.str();
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Counters of long match and datagen runs, exported in the Prometheus text format.
+// Every thread counts into a shard of its own with relaxed atomics, scrape() adds the shards up.
+class Metrics {
+   public:
+    enum class Counter
+    {
+        GamesFinished,
+        GamesFailed,
+        Forfeits,
+        EngineCrashes,
+        EngineHangs,
+        Moves,
+        DatagenGames,
+        DatagenPositions,
+    };
+    static constexpr std::size_t num_counters = 8;
+
+    enum class Gauge
+    {
+        // Games the match runner's slots have queued
+        QueuedGames,
+        // Games waiting for the datagen writer
+        WriterQueue,
+    };
+    static constexpr std::size_t num_gauges = 2;
+
+    static constexpr int max_slots = 256;
+
+    [[nodiscard]] static Metrics &instance();
+
+    void add(Counter counter, std::uint64_t n = 1);
+    void set(Gauge gauge, std::int64_t value);
+    // Depth and speed an engine reported for a search
+    void observe_search(std::optional<int> depth, std::optional<std::int64_t> nps);
+    // Slots are busy while they play a game
+    void set_slot_busy(int slot, bool busy);
+
+    // All metrics in the Prometheus text exposition format
+    [[nodiscard]] std::string scrape() const;
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::array<double, 11> depth_buckets = {1, 2, 4, 6, 8, 10, 12, 16, 20, 24, 32};
+    static constexpr std::array<double, 8> nps_buckets = {1e3, 1e4, 1e5, 3e5, 1e6, 3e6, 1e7, 3e7};
+
+    template <std::size_t N>
+    struct Histogram {
+        // One more for +Inf, the counts aren't cumulative until scrape()
+        std::array<std::atomic<std::uint64_t>, N + 1> buckets{};
+        std::atomic<std::uint64_t> sum = 0;
+    };
+
+    struct Shard {
+        std::array<std::atomic<std::uint64_t>, num_counters> counters{};
+        Histogram<depth_buckets.size()> depth;
+        Histogram<nps_buckets.size()> nps;
+    };
+
+    struct Slot {
+        // Clock ticks, 0 while the slot is idle
+        std::atomic<std::int64_t> busy_since = 0;
+        std::atomic<std::int64_t> busy_total = 0;
+    };
+
+    Metrics();
+    [[nodiscard]] Shard &shard();
+    [[nodiscard]] std::int64_t now() const;
+
+    Clock::time_point m_start;
+    mutable std::mutex m_mutex;
+    // Shards outlive their threads, so no count is lost
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    std::array<std::atomic<std::int64_t>, num_gauges> m_gauges{};
+    std::array<Slot, max_slots> m_slots;
+    std::atomic<int> m_num_slots = 0;
+};
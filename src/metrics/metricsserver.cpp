@@ -0,0 +1,70 @@
+#include "metricsserver.hpp"
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <memory>
+#include <stdexcept>
+#include "metrics.hpp"
+
+namespace {
+
+// Requests are small, anything bigger isn't a scrape
+constexpr qint64 max_request_size = 16 * 1024;
+
+void serve(QTcpSocket *socket) {
+    auto request = std::make_shared<QByteArray>();
+    QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    QObject::connect(socket, &QTcpSocket::readyRead, socket, [socket, request]() {
+        request->append(socket->readAll());
+        if (request->size() > max_request_size) {
+            socket->abort();
+            return;
+        }
+        // Answer once the headers are complete
+        if (!request->contains("\r\n\r\n") && !request->contains("\n\n")) {
+            return;
+        }
+        const auto body = QByteArray::fromStdString(Metrics::instance().scrape());
+        QByteArray response = "HTTP/1.1 200 OK\r\n"
+                              "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                              "Connection: close\r\n"
+                              "Content-Length: ";
+        response += QByteArray::number(body.size()) + "\r\n\r\n" + body;
+        socket->write(response);
+        socket->disconnectFromHost();
+    });
+}
+
+}  // namespace
+
+MetricsServer::MetricsServer(const MetricsSettings &settings) {
+    m_server = new QTcpServer;
+    m_server->moveToThread(&m_thread);
+    QObject::connect(&m_thread, &QThread::finished, m_server, &QObject::deleteLater);
+    m_thread.start();
+
+    bool listening = false;
+    QMetaObject::invokeMethod(
+        m_server,
+        [server = m_server, &settings, &listening]() {
+            QObject::connect(server, &QTcpServer::newConnection, server, [server]() {
+                while (auto *socket = server->nextPendingConnection()) {
+                    serve(socket);
+                }
+            });
+            listening = server->listen(QHostAddress(QString::fromStdString(settings.address)), settings.port);
+        },
+        Qt::BlockingQueuedConnection);
+
+    if (!listening) {
+        m_thread.quit();
+        m_thread.wait();
+        throw std::runtime_error("Could not serve metrics on " + settings.address + ":" +
+                                 std::to_string(settings.port));
+    }
+}
+
+MetricsServer::~MetricsServer() {
+    m_thread.quit();
+    m_thread.wait();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QThread>
+#include <cstdint>
+#include <string>
+
+class QTcpServer;
+
+struct MetricsSettings {
+    // 0 turns the endpoint off
+    std::uint16_t port = 0;
+    std::string address = "127.0.0.1";
+};
+
+// Serves Metrics::scrape() over HTTP for Prometheus or curl, on a thread of its own so a busy GUI
+// thread doesn't delay scrapes. Any path answers with the metrics.
+class MetricsServer {
+   public:
+    // Throws if it can't listen on the port
+    explicit MetricsServer(const MetricsSettings &settings);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer &) = delete;
+    MetricsServer &operator=(const MetricsServer &) = delete;
+
+   private:
+    QThread m_thread;
+    QTcpServer *m_server = nullptr;
+};
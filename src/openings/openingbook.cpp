@@ -0,0 +1,123 @@
+#include "openingbook.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr char book_magic[8] = {'A', 'T', 'X', 'B', 'O', 'O', 'K', '1'};
+
+struct Header {
+    char magic[8];
+    std::uint64_t num_entries;
+};
+
+}  // namespace
+
+void OpeningBook::build_from_tree(const OpeningTree &tree, const std::string &out_path, std::uint32_t min_games) {
+    std::vector<Entry> entries;
+    for (const auto &node : tree.nodes()) {
+        std::uint32_t max_points = 0;
+        for (const auto &edge : tree.edges(node)) {
+            if (edge.games >= min_games) {
+                max_points = std::max(max_points, edge.half_points);
+            }
+        }
+        if (max_points == 0) {
+            continue;
+        }
+
+        // Keep the relative weights of a position when they don't fit into 16 bits
+        const double scale = std::min(1.0, 65535.0 / max_points);
+        const auto first = entries.size();
+        for (const auto &edge : tree.edges(node)) {
+            const auto weight = static_cast<std::uint16_t>(edge.half_points * scale);
+            if (edge.games >= min_games && weight > 0) {
+                entries.push_back(Entry{node.key, edge.move, weight, 0});
+            }
+        }
+        std::sort(entries.begin() + static_cast<std::ptrdiff_t>(first), entries.end(), [](const auto &a, const auto &b) {
+            return a.weight > b.weight;
+        });
+    }
+
+    std::ofstream out(out_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not open " + out_path + " for writing");
+    }
+    Header header{};
+    std::memcpy(header.magic, book_magic, sizeof(book_magic));
+    header.num_entries = entries.size();
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(entries.data()),
+              static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+    if (!out) {
+        throw std::runtime_error("Failed to write " + out_path);
+    }
+}
+
+void OpeningBook::build_from_pgn(const std::vector<std::string> &pgn_paths,
+                                 const std::string &out_path,
+                                 int max_ply,
+                                 std::uint32_t min_games) {
+    const auto tree_path = out_path + ".tree.tmp";
+    OpeningTree::build(pgn_paths, tree_path, max_ply);
+    {
+        const OpeningTree tree(tree_path);
+        build_from_tree(tree, out_path, min_games);
+    }
+    std::filesystem::remove(tree_path);
+}
+
+OpeningBook::OpeningBook(const std::string &path) : m_file(path) {
+    Header header{};
+    if (m_file.size() < sizeof(header)) {
+        throw std::runtime_error(path + " is not an opening book");
+    }
+    std::memcpy(&header, m_file.data(), sizeof(header));
+    if (std::memcmp(header.magic, book_magic, sizeof(book_magic)) != 0 ||
+        m_file.size() != sizeof(header) + header.num_entries * sizeof(Entry)) {
+        throw std::runtime_error(path + " is not an opening book");
+    }
+    m_entries =
+        std::span<const Entry>(reinterpret_cast<const Entry *>(m_file.data() + sizeof(header)), header.num_entries);
+}
+
+std::vector<OpeningBook::BookMove> OpeningBook::moves(const libataxx::Position &pos) const {
+    const auto key = canonical_key(pos);
+    const auto first = std::lower_bound(m_entries.begin(), m_entries.end(), key.hash, [](const Entry &e, std::uint64_t k) {
+        return e.key < k;
+    });
+
+    std::vector<BookMove> moves;
+    for (auto it = first; it != m_entries.end() && it->key == key.hash; ++it) {
+        const auto move = unpack_move(transform_move(it->move, inverse(key.symmetry)));
+        // Guards against hash collisions
+        if (pos.is_legal_move(move)) {
+            moves.push_back(BookMove{move, it->weight});
+        }
+    }
+    return moves;
+}
+
+std::optional<libataxx::Move> OpeningBook::pick(const libataxx::Position &pos, std::mt19937_64 &rng) const {
+    const auto candidates = moves(pos);
+    std::uint64_t total = 0;
+    for (const auto &candidate : candidates) {
+        total += candidate.weight;
+    }
+    if (total == 0) {
+        return std::nullopt;
+    }
+
+    auto choice = std::uniform_int_distribution<std::uint64_t>(0, total - 1)(rng);
+    for (const auto &candidate : candidates) {
+        if (choice < candidate.weight) {
+            return candidate.move;
+        }
+        choice -= candidate.weight;
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <libataxx/move.hpp>
+#include <libataxx/position.hpp>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+#include "../boardsymmetry.hpp"
+#include "../mappedfile.hpp"
+#include "openingtree.hpp"
+
+// Binary opening book: entries sorted by symmetry-canonical position hash, read through mmap.
+class OpeningBook {
+   public:
+    struct Entry {
+        std::uint64_t key;
+        // In the canonical orientation of the position
+        PackedMove move;
+        std::uint16_t weight;
+        std::uint32_t reserved;
+    };
+
+    // Weight of a move is the number of half points the mover scored with it.
+    static void build_from_tree(const OpeningTree &tree, const std::string &out_path, std::uint32_t min_games = 1);
+    static void build_from_pgn(const std::vector<std::string> &pgn_paths,
+                               const std::string &out_path,
+                               int max_ply = OpeningTree::default_max_ply,
+                               std::uint32_t min_games = 1);
+
+    explicit OpeningBook(const std::string &path);
+
+    struct BookMove {
+        libataxx::Move move;
+        std::uint16_t weight;
+    };
+
+    [[nodiscard]] std::vector<BookMove> moves(const libataxx::Position &pos) const;
+    // Weighted random choice among the book moves of the position.
+    [[nodiscard]] std::optional<libataxx::Move> pick(const libataxx::Position &pos, std::mt19937_64 &rng) const;
+
+    [[nodiscard]] std::size_t size() const {
+        return m_entries.size();
+    }
+
+   private:
+    MappedFile m_file;
+    std::span<const Entry> m_entries;
+};
@@ -0,0 +1,171 @@
+#include "openinggenerator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <libataxx/position.hpp>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include "../atomichashset.hpp"
+#include "../boardsymmetry.hpp"
+#include "../engines/enginefactory.hpp"
+#include "../engines/engineinfo.hpp"
+
+namespace {
+
+// Give up once a thread only finds positions it has seen before
+constexpr int max_duplicates_in_row = 100000;
+
+std::optional<libataxx::Position> random_opening(const OpeningGeneratorSettings &settings, std::mt19937_64 &rng) {
+    std::uniform_int_distribution<std::size_t> base_dist(0, settings.base_fens.size() - 1);
+    std::uniform_int_distribution<int> ply_dist(settings.min_plies, settings.max_plies);
+
+    auto pos = libataxx::Position(settings.base_fens[base_dist(rng)]);
+    const int plies = ply_dist(rng);
+    for (int i = 0; i < plies; ++i) {
+        const auto moves = pos.legal_moves();
+        // Openings with a forced pass or a finished game aren't worth playing
+        if (pos.is_gameover() || moves.empty() || moves.front() == libataxx::Move::nullmove()) {
+            return std::nullopt;
+        }
+        std::uniform_int_distribution<std::size_t> move_dist(0, moves.size() - 1);
+        pos.makemove(moves[move_dist(rng)]);
+    }
+    if (pos.is_gameover()) {
+        return std::nullopt;
+    }
+    return pos;
+}
+
+// One engine per thread, only created when the balance filter is used
+class BalanceFilter {
+   public:
+    explicit BalanceFilter(const OpeningGeneratorSettings &settings) : m_max_score(settings.max_score) {
+        m_tc.type = SearchSettings::Type::Nodes;
+        m_tc.nodes = settings.nodes;
+
+        m_engine = create_engine(settings.engine.value(), {}, [this](const std::string &line) {
+            if (const auto score = parse_score(line)) {
+                m_score = score;
+            }
+        });
+        m_engine->init();
+        for (const auto &[name, value] : settings.engine->options) {
+            m_engine->set_option(name, value);
+        }
+        m_engine->isready();
+    }
+
+    ~BalanceFilter() {
+        m_engine->quit();
+    }
+
+    [[nodiscard]] std::optional<int> evaluate(const libataxx::Position &pos) {
+        m_score = std::nullopt;
+        m_engine->newgame();
+        m_engine->position(pos);
+        static_cast<void>(m_engine->go(m_tc));
+        return m_score;
+    }
+
+    [[nodiscard]] bool is_balanced(const std::optional<int> &score) const {
+        return score.has_value() && std::abs(score.value()) <= m_max_score;
+    }
+
+   private:
+    std::shared_ptr<Engine> m_engine;
+    SearchSettings m_tc;
+    int m_max_score;
+    std::optional<int> m_score;
+};
+
+}  // namespace
+
+std::size_t generate_openings(const OpeningGeneratorSettings &settings,
+                              const std::string &out_path,
+                              std::function<void(std::size_t)> on_progress) {
+    if (settings.base_fens.empty()) {
+        throw std::invalid_argument("No base positions to generate openings from");
+    }
+    if (settings.min_plies < 0 || settings.max_plies < settings.min_plies) {
+        throw std::invalid_argument("Invalid ply range");
+    }
+
+    std::ofstream out(out_path);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not open " + out_path);
+    }
+
+    // Rejected positions stay in the set too, so they aren't evaluated again
+    AtomicHashSet seen(settings.count * (settings.engine.has_value() ? 16 : 4));
+    std::atomic<std::size_t> written = 0;
+    // Set when the dedup set is full or a thread failed
+    std::atomic<bool> stop = false;
+    std::mutex out_mutex;
+    std::string error;
+
+    const unsigned num_threads = settings.threads > 0 ? settings.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            try {
+                std::mt19937_64 rng(settings.seed ^ (0x9E3779B97F4A7C15ULL * (t + 1)));
+                std::optional<BalanceFilter> filter;
+                if (settings.engine.has_value()) {
+                    filter.emplace(settings);
+                }
+
+                int duplicates = 0;
+                while (written.load(std::memory_order_relaxed) < settings.count && !stop &&
+                       duplicates < max_duplicates_in_row) {
+                    const auto pos = random_opening(settings, rng);
+                    if (!pos.has_value()) {
+                        continue;
+                    }
+
+                    const auto inserted = seen.insert(canonical_hash(pos.value()));
+                    if (inserted == AtomicHashSet::Insert::Full) {
+                        stop = true;
+                        break;
+                    } else if (inserted == AtomicHashSet::Insert::Present) {
+                        duplicates++;
+                        continue;
+                    }
+                    duplicates = 0;
+
+                    std::string line = pos->get_fen();
+                    if (filter.has_value()) {
+                        const auto score = filter->evaluate(pos.value());
+                        if (!filter->is_balanced(score)) {
+                            continue;
+                        }
+                        line += " ; eval " + std::to_string(score.value());
+                    }
+
+                    std::lock_guard lock(out_mutex);
+                    if (written < settings.count) {
+                        out << line << "\n";
+                        const auto n = ++written;
+                        if (on_progress) {
+                            on_progress(n);
+                        }
+                    }
+                }
+            } catch (const std::exception &e) {
+                std::lock_guard lock(out_mutex);
+                error = e.what();
+                stop = true;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+    return written;
+}
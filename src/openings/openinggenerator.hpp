@@ -0,0 +1,34 @@
+#pragma once
+
+#include <../core/engine/settings.hpp>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct OpeningGeneratorSettings {
+    // Number of unique openings to write
+    std::size_t count = 1000;
+    // Random plies played from the base position, picked uniformly in [min_plies, max_plies]
+    int min_plies = 4;
+    int max_plies = 8;
+    // Base positions, one picked at random for every opening
+    std::vector<std::string> base_fens;
+    std::uint64_t seed = 0;
+    // 0 uses every core
+    unsigned threads = 0;
+
+    // Optional balance filter, keeps openings the engine scores within max_score after a fixed node search
+    std::optional<EngineSettings> engine;
+    int nodes = 10000;
+    int max_score = 100;
+};
+
+// Plays random openings on all threads and writes the unique ones to out_path, one FEN per line.
+// Positions that are the same up to rotation or reflection count as duplicates.
+// Returns the number of openings written, which is less than settings.count if the generator ran
+// out of new positions.
+std::size_t generate_openings(const OpeningGeneratorSettings &settings,
+                              const std::string &out_path,
+                              std::function<void(std::size_t)> on_progress = {});
@@ -0,0 +1,163 @@
+#include "openingsuite.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include "pgnreader.hpp"
+
+namespace {
+
+bool is_blank_or_comment(const char *begin, const char *end) {
+    while (begin != end && std::isspace(static_cast<unsigned char>(*begin))) {
+        ++begin;
+    }
+    return begin == end || *begin == '#' || *begin == ';';
+}
+
+bool is_integer(const std::string &token) {
+    return !token.empty() && std::all_of(token.begin(), token.end(), [](char c) {
+        return std::isdigit(static_cast<unsigned char>(c));
+    });
+}
+
+// EPD lines may carry opcodes instead of move counters ("x5o/7/7/7/7/7/o5x x hmvc 0; id ...")
+std::string epd_to_fen(const std::string &line) {
+    std::istringstream in(line.substr(0, line.find(';')));
+    std::vector<std::string> tokens;
+    std::string token;
+    while (tokens.size() < 4 && in >> token) {
+        tokens.push_back(token);
+    }
+    if (tokens.size() < 2) {
+        throw std::runtime_error("Invalid opening \"" + line + "\"");
+    }
+    if (tokens.size() == 4 && is_integer(tokens[2]) && is_integer(tokens[3])) {
+        return tokens[0] + " " + tokens[1] + " " + tokens[2] + " " + tokens[3];
+    }
+    return tokens[0] + " " + tokens[1] + " 0 1";
+}
+
+}  // namespace
+
+OpeningSuite::OpeningSuite(const OpeningSuiteSettings &settings) : m_file(settings.file), m_order(settings.order) {
+    auto extension = std::filesystem::path(settings.file).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    m_is_pgn = extension == ".pgn";
+
+    if (m_is_pgn || m_order == OpeningSuiteSettings::Order::Random) {
+        index_openings();
+        if (m_offsets.empty()) {
+            throw std::runtime_error("No openings in " + settings.file);
+        }
+        if (m_order == OpeningSuiteSettings::Order::Random) {
+            std::mt19937_64 rng(settings.seed);
+            std::shuffle(m_offsets.begin(), m_offsets.end(), rng);
+        }
+        m_cursor = settings.start % m_offsets.size();
+    } else {
+        for (std::uint64_t i = 0; i < settings.start; ++i) {
+            static_cast<void>(next());
+        }
+    }
+    m_count = settings.start;
+}
+
+std::string OpeningSuite::next() {
+    std::lock_guard lock(m_mutex);
+    const char *data = m_file.data();
+    const std::size_t size = m_file.size();
+
+    if (!m_offsets.empty()) {
+        const auto begin = m_offsets[m_cursor];
+        m_cursor = (m_cursor + 1) % m_offsets.size();
+        ++m_count;
+        return opening_at(begin, size);
+    }
+
+    // Sequential EPD needs no index, the cursor is a byte offset into the file
+    for (std::size_t attempts = 0; attempts < 2; ++attempts) {
+        while (m_cursor < size) {
+            const auto line_end = std::find(data + m_cursor, data + size, '\n');
+            const auto begin = m_cursor;
+            m_cursor = static_cast<std::size_t>(line_end - data) + 1;
+            if (!is_blank_or_comment(data + begin, line_end)) {
+                ++m_count;
+                return epd_to_fen(std::string(data + begin, line_end));
+            }
+        }
+        m_cursor = 0;
+    }
+    throw std::runtime_error("No openings in suite");
+}
+
+std::uint64_t OpeningSuite::position() const {
+    std::lock_guard lock(m_mutex);
+    return m_count;
+}
+
+std::string OpeningSuite::opening_at(std::size_t begin, std::size_t end) const {
+    const char *data = m_file.data();
+    if (!m_is_pgn) {
+        return epd_to_fen(std::string(data + begin, std::find(data + begin, data + end, '\n')));
+    }
+
+    // The game ends where the next game's tags start
+    std::size_t game_end = begin;
+    bool in_movetext = false;
+    while (game_end < end) {
+        const auto line_end = static_cast<std::size_t>(std::find(data + game_end, data + end, '\n') - data);
+        if (data[game_end] == '[' && in_movetext) {
+            break;
+        }
+        if (data[game_end] != '[' && !is_blank_or_comment(data + game_end, data + line_end)) {
+            in_movetext = true;
+        }
+        game_end = std::min(end, line_end + 1);
+    }
+
+    std::istringstream in(std::string(data + begin, data + game_end));
+    std::string fen;
+    read_pgn_games(in, [&fen](PgnGame &&game) {
+        fen = replay_game(game,
+                          [](const libataxx::Position &, const libataxx::Move &, std::size_t) {
+                              return true;
+                          })
+                  .get_fen();
+        return false;
+    });
+    if (fen.empty()) {
+        throw std::runtime_error("Invalid PGN opening");
+    }
+    return fen;
+}
+
+void OpeningSuite::index_openings() {
+    const char *data = m_file.data();
+    const std::size_t size = m_file.size();
+    bool in_movetext = true;
+    std::size_t pos = 0;
+    while (pos < size) {
+        const auto line_end = static_cast<std::size_t>(std::find(data + pos, data + size, '\n') - data);
+        if (m_is_pgn) {
+            if (data[pos] == '[') {
+                if (in_movetext) {
+                    m_offsets.push_back(pos);
+                }
+                in_movetext = false;
+            } else if (!is_blank_or_comment(data + pos, data + line_end)) {
+                if (m_offsets.empty()) {
+                    // Movetext without tags starts a game of its own
+                    m_offsets.push_back(pos);
+                }
+                in_movetext = true;
+            }
+        } else if (!is_blank_or_comment(data + pos, data + line_end)) {
+            m_offsets.push_back(pos);
+        }
+        pos = line_end + 1;
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../mappedfile.hpp"
+
+struct OpeningSuiteSettings {
+    enum class Order
+    {
+        Sequential,
+        Random,
+    };
+
+    // EPD or FEN lines, or a PGN file whose games are played out to get the opening position
+    std::string file;
+    Order order = Order::Sequential;
+    std::uint64_t seed = 0;
+    // Index of the first opening, so a run can continue where an earlier one stopped
+    std::uint64_t start = 0;
+};
+
+// Hands out opening positions from a suite file of any size. The file is memory-mapped and
+// parsed one opening at a time; only the offsets of the openings are kept for random order.
+class OpeningSuite {
+   public:
+    explicit OpeningSuite(const OpeningSuiteSettings &settings);
+
+    // Thread-safe. Wraps around at the end of the suite.
+    [[nodiscard]] std::string next();
+
+    // Number of openings handed out so far, counting from settings.start
+    [[nodiscard]] std::uint64_t position() const;
+
+   private:
+    [[nodiscard]] std::string opening_at(std::size_t begin, std::size_t end) const;
+    void index_openings();
+
+    MappedFile m_file;
+    bool m_is_pgn;
+    OpeningSuiteSettings::Order m_order;
+    // Start offsets of all openings, only built when they are needed
+    std::vector<std::uint64_t> m_offsets;
+    mutable std::mutex m_mutex;
+    std::size_t m_cursor = 0;
+    std::uint64_t m_count = 0;
+};
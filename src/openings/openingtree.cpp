@@ -0,0 +1,199 @@
+#include "openingtree.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include "pgnreader.hpp"
+
+namespace {
+
+constexpr char tree_magic[8] = {'A', 'T', 'X', 'T', 'R', 'E', 'E', '1'};
+constexpr std::size_t batch_size = 4096;
+
+struct Header {
+    char magic[8];
+    std::uint64_t num_nodes;
+    std::uint64_t num_edges;
+};
+
+struct EdgeKey {
+    std::uint64_t key;
+    PackedMove move;
+
+    bool operator==(const EdgeKey &) const = default;
+    auto operator<=>(const EdgeKey &) const = default;
+};
+
+struct EdgeKeyHash {
+    std::size_t operator()(const EdgeKey &k) const {
+        return k.key ^ (static_cast<std::uint64_t>(k.move) * 0x9e3779b97f4a7c15ULL);
+    }
+};
+
+struct EdgeStats {
+    std::uint32_t games = 0;
+    std::uint32_t half_points = 0;
+    std::uint32_t eval_count = 0;
+    double eval_sum = 0.0;
+
+    void merge(const EdgeStats &other) {
+        games += other.games;
+        half_points += other.half_points;
+        eval_count += other.eval_count;
+        eval_sum += other.eval_sum;
+    }
+};
+
+using EdgeMap = std::unordered_map<EdgeKey, EdgeStats, EdgeKeyHash>;
+
+void add_game(EdgeMap &edges, const PgnGame &game, int max_ply) {
+    const auto score = black_score(game.result);
+    if (!score.has_value()) {
+        return;
+    }
+    replay_game(game, [&](const libataxx::Position &pos, const libataxx::Move &move, std::size_t ply) {
+        if (ply >= static_cast<std::size_t>(max_ply)) {
+            return false;
+        }
+        const auto key = canonical_key(pos);
+        const auto mover_score = pos.get_turn() == libataxx::Side::Black ? score.value() : 1.0 - score.value();
+        auto &stats = edges[EdgeKey{key.hash, transform_move(pack_move(move), key.symmetry)}];
+        stats.games += 1;
+        stats.half_points += static_cast<std::uint32_t>(mover_score * 2.0);
+        if (game.evals[ply].has_value()) {
+            stats.eval_count += 1;
+            stats.eval_sum += static_cast<double>(game.evals[ply].value());
+        }
+        return true;
+    });
+}
+
+}  // namespace
+
+void OpeningTree::build(const std::vector<std::string> &pgn_paths,
+                        const std::string &out_path,
+                        int max_ply,
+                        unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    // Games are read in batches and replayed in parallel, every worker aggregating into its own map
+    std::vector<EdgeMap> worker_edges(threads);
+    std::vector<PgnGame> batch;
+    const auto process_batch = [&]() {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                for (std::size_t i = t; i < batch.size(); i += threads) {
+                    add_game(worker_edges[t], batch[i], max_ply);
+                }
+            });
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        batch.clear();
+    };
+
+    for (const auto &path : pgn_paths) {
+        std::ifstream in(path);
+        if (!in.is_open()) {
+            throw std::runtime_error("Could not open PGN file " + path);
+        }
+        read_pgn_games(in, [&](PgnGame &&game) {
+            batch.push_back(std::move(game));
+            if (batch.size() >= batch_size) {
+                process_batch();
+            }
+            return true;
+        });
+    }
+    process_batch();
+
+    std::vector<std::pair<EdgeKey, EdgeStats>> merged;
+    for (auto &edges : worker_edges) {
+        merged.insert(merged.end(), edges.begin(), edges.end());
+        edges = EdgeMap{};
+    }
+    std::sort(merged.begin(), merged.end(), [](const auto &a, const auto &b) {
+        return a.first < b.first;
+    });
+
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;
+    for (std::size_t i = 0; i < merged.size(); ++i) {
+        const auto &[key, stats] = merged[i];
+        if (!edges.empty() && merged[i - 1].first == key) {
+            EdgeStats sum{edges.back().games, edges.back().half_points, edges.back().eval_count, edges.back().eval_sum};
+            sum.merge(stats);
+            edges.back() = Edge{key.move, 0, sum.games, sum.half_points, sum.eval_count, sum.eval_sum};
+            continue;
+        }
+        if (nodes.empty() || nodes.back().key != key.key) {
+            nodes.push_back(Node{key.key, static_cast<std::uint32_t>(edges.size()), 0});
+        }
+        nodes.back().num_edges += 1;
+        edges.push_back(Edge{key.move, 0, stats.games, stats.half_points, stats.eval_count, stats.eval_sum});
+    }
+
+    std::ofstream out(out_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not open " + out_path + " for writing");
+    }
+    Header header{};
+    std::memcpy(header.magic, tree_magic, sizeof(tree_magic));
+    header.num_nodes = nodes.size();
+    header.num_edges = edges.size();
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(nodes.data()), static_cast<std::streamsize>(nodes.size() * sizeof(Node)));
+    out.write(reinterpret_cast<const char *>(edges.data()), static_cast<std::streamsize>(edges.size() * sizeof(Edge)));
+    if (!out) {
+        throw std::runtime_error("Failed to write " + out_path);
+    }
+}
+
+OpeningTree::OpeningTree(const std::string &path) : m_file(path) {
+    Header header{};
+    if (m_file.size() < sizeof(header)) {
+        throw std::runtime_error(path + " is not an opening tree");
+    }
+    std::memcpy(&header, m_file.data(), sizeof(header));
+    const auto expected_size = sizeof(header) + header.num_nodes * sizeof(Node) + header.num_edges * sizeof(Edge);
+    if (std::memcmp(header.magic, tree_magic, sizeof(tree_magic)) != 0 || m_file.size() != expected_size) {
+        throw std::runtime_error(path + " is not an opening tree");
+    }
+    const auto *nodes = reinterpret_cast<const Node *>(m_file.data() + sizeof(header));
+    m_nodes = std::span<const Node>(nodes, header.num_nodes);
+    m_edges = std::span<const Edge>(reinterpret_cast<const Edge *>(nodes + header.num_nodes), header.num_edges);
+}
+
+std::vector<ExplorerMove> OpeningTree::moves(const libataxx::Position &pos) const {
+    const auto key = canonical_key(pos);
+    const auto node = std::lower_bound(m_nodes.begin(), m_nodes.end(), key.hash, [](const Node &n, std::uint64_t k) {
+        return n.key < k;
+    });
+    if (node == m_nodes.end() || node->key != key.hash) {
+        return {};
+    }
+
+    std::vector<ExplorerMove> moves;
+    for (const auto &edge : edges(*node)) {
+        ExplorerMove move{
+            .move = unpack_move(transform_move(edge.move, inverse(key.symmetry))),
+            .games = edge.games,
+            .score = edge.games > 0 ? edge.half_points / (2.0 * edge.games) : 0.0,
+            .eval = std::nullopt,
+        };
+        if (edge.eval_count > 0) {
+            move.eval = edge.eval_sum / edge.eval_count;
+        }
+        moves.push_back(move);
+    }
+    std::sort(moves.begin(), moves.end(), [](const auto &a, const auto &b) {
+        return a.games > b.games;
+    });
+    return moves;
+}
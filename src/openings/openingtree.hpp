@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <libataxx/move.hpp>
+#include <libataxx/position.hpp>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include "../boardsymmetry.hpp"
+#include "../mappedfile.hpp"
+
+struct ExplorerMove {
+    libataxx::Move move;
+    std::uint32_t games = 0;
+    // Score of the side to move, from 0 to 1
+    double score = 0.0;
+    // Average eval the mover reported after the move, in the units of the PGN comments
+    std::optional<double> eval;
+};
+
+// Move statistics aggregated from stored games, keyed by symmetry-canonical position hash.
+// The file is a sorted node array followed by the edges of each node, and is only ever read through mmap.
+class OpeningTree {
+   public:
+    struct Node {
+        std::uint64_t key;
+        std::uint32_t first_edge;
+        std::uint32_t num_edges;
+    };
+
+    struct Edge {
+        // In the canonical orientation of the node
+        PackedMove move;
+        std::uint16_t reserved;
+        std::uint32_t games;
+        std::uint32_t half_points;
+        std::uint32_t eval_count;
+        double eval_sum;
+    };
+
+    static constexpr int default_max_ply = 40;
+
+    // Replays every game of the PGN files on `threads` workers and writes the tree to out_path.
+    static void build(const std::vector<std::string> &pgn_paths,
+                      const std::string &out_path,
+                      int max_ply = default_max_ply,
+                      unsigned threads = 0);
+
+    explicit OpeningTree(const std::string &path);
+
+    [[nodiscard]] std::vector<ExplorerMove> moves(const libataxx::Position &pos) const;
+
+    [[nodiscard]] std::span<const Node> nodes() const {
+        return m_nodes;
+    }
+
+    [[nodiscard]] std::span<const Edge> edges(const Node &node) const {
+        return m_edges.subspan(node.first_edge, node.num_edges);
+    }
+
+   private:
+    MappedFile m_file;
+    std::span<const Node> m_nodes;
+    std::span<const Edge> m_edges;
+};
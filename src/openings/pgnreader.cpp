@@ -0,0 +1,188 @@
+#include "pgnreader.hpp"
+#include <cctype>
+#include <cstdlib>
+
+namespace {
+
+bool is_result_token(const std::string &token) {
+    return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+}
+
+// "+0.35/12" or "-1.2" give an eval, "0.5s" and "book" don't
+std::optional<float> parse_eval(const std::string &comment) {
+    std::size_t begin = 0;
+    while (begin < comment.size() && std::isspace(static_cast<unsigned char>(comment[begin]))) {
+        ++begin;
+    }
+    if (begin == comment.size()) {
+        return std::nullopt;
+    }
+    const char c = comment[begin];
+    if (c != '+' && c != '-' && !std::isdigit(static_cast<unsigned char>(c))) {
+        return std::nullopt;
+    }
+    char *end = nullptr;
+    const float eval = std::strtof(comment.c_str() + begin, &end);
+    if (end == comment.c_str() + begin) {
+        return std::nullopt;
+    }
+    if (*end != '\0' && *end != '/' && !std::isspace(static_cast<unsigned char>(*end))) {
+        return std::nullopt;
+    }
+    return eval;
+}
+
+struct PgnParser {
+    PgnGame game;
+    bool in_movetext = false;
+    bool in_comment = false;
+    int variation_depth = 0;
+    std::string comment;
+
+    void add_comment() {
+        if (!game.moves.empty() && !game.evals.back().has_value()) {
+            game.evals.back() = parse_eval(comment);
+        }
+        comment.clear();
+    }
+
+    void add_token(std::string token) {
+        // strip move numbers such as "12." or "12..." which may be glued to the move
+        std::size_t i = 0;
+        while (i < token.size() && std::isdigit(static_cast<unsigned char>(token[i]))) {
+            ++i;
+        }
+        if (i > 0 && i < token.size() && token[i] == '.') {
+            while (i < token.size() && token[i] == '.') {
+                ++i;
+            }
+            token = token.substr(i);
+        }
+        if (token.empty() || token.front() == '$') {
+            return;
+        }
+        game.moves.push_back(token);
+        game.evals.emplace_back(std::nullopt);
+    }
+};
+
+}  // namespace
+
+void read_pgn_games(std::istream &in, const std::function<bool(PgnGame &&)> &on_game) {
+    PgnParser parser;
+    bool has_game = false;
+
+    const auto finish_game = [&]() {
+        const bool keep_going = !has_game || on_game(std::move(parser.game));
+        parser = PgnParser{};
+        has_game = false;
+        return keep_going;
+    };
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!parser.in_comment && !line.empty() && line.front() == '[') {
+            if (parser.in_movetext && !finish_game()) {
+                return;
+            }
+            has_game = true;
+            const auto key_end = line.find(' ');
+            const auto value_begin = line.find('"');
+            const auto value_end = line.rfind('"');
+            if (key_end != std::string::npos && value_begin != std::string::npos && value_end > value_begin) {
+                const auto key = line.substr(1, key_end - 1);
+                const auto value = line.substr(value_begin + 1, value_end - value_begin - 1);
+                if (key == "FEN") {
+                    parser.game.fen = value;
+                } else if (key == "Result") {
+                    parser.game.result = value;
+                }
+            }
+            continue;
+        }
+
+        std::string token;
+        for (const char c : line) {
+            if (parser.in_comment) {
+                if (c == '}') {
+                    parser.in_comment = false;
+                    parser.add_comment();
+                } else {
+                    parser.comment += c;
+                }
+                continue;
+            }
+            if (parser.variation_depth > 0) {
+                parser.variation_depth += c == '(' ? 1 : c == ')' ? -1 : 0;
+                continue;
+            }
+            if (c == '{' || c == '(' || c == ';' || std::isspace(static_cast<unsigned char>(c))) {
+                if (!token.empty()) {
+                    has_game = parser.in_movetext = true;
+                    if (is_result_token(token)) {
+                        parser.game.result = token;
+                        if (!finish_game()) {
+                            return;
+                        }
+                    } else {
+                        parser.add_token(token);
+                    }
+                    token.clear();
+                }
+                if (c == ';') {
+                    break;
+                }
+                parser.in_comment = c == '{';
+                parser.variation_depth = c == '(' ? 1 : 0;
+                continue;
+            }
+            token += c;
+        }
+        if (!token.empty()) {
+            has_game = parser.in_movetext = true;
+            if (is_result_token(token)) {
+                parser.game.result = token;
+                if (!finish_game()) {
+                    return;
+                }
+            } else {
+                parser.add_token(token);
+            }
+        }
+    }
+    finish_game();
+}
+
+std::optional<double> black_score(const std::string &result) {
+    if (result == "1-0") {
+        return 1.0;
+    } else if (result == "0-1") {
+        return 0.0;
+    } else if (result == "1/2-1/2") {
+        return 0.5;
+    }
+    return std::nullopt;
+}
+
+std::optional<libataxx::Move> find_legal_move(const libataxx::Position &pos, const std::string &move) {
+    for (const auto &legal : pos.legal_moves()) {
+        if (static_cast<std::string>(legal) == move) {
+            return legal;
+        }
+    }
+    return std::nullopt;
+}
+
+libataxx::Position replay_game(
+    const PgnGame &game,
+    const std::function<bool(const libataxx::Position &pos, const libataxx::Move &move, std::size_t ply)> &on_move) {
+    auto pos = libataxx::Position(game.fen);
+    for (std::size_t ply = 0; ply < game.moves.size(); ++ply) {
+        const auto move = find_legal_move(pos, game.moves[ply]);
+        if (!move.has_value() || !on_move(pos, move.value(), ply)) {
+            break;
+        }
+        pos.makemove(move.value());
+    }
+    return pos;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <functional>
+#include <istream>
+#include <libataxx/move.hpp>
+#include <libataxx/position.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+inline const std::string default_start_fen = "x5o/7/7/7/7/7/o5x x 0 1";
+
+struct PgnGame {
+    // From the FEN tag, or the default start position if there is none
+    std::string fen = default_start_fen;
+    std::vector<std::string> moves;
+    // Eval the mover gave in the comment after each move ("{+0.35/12 0.5s}")
+    std::vector<std::optional<float>> evals;
+    std::string result = "*";
+};
+
+// Calls on_game for every game in the stream without holding more than one game in memory.
+// Stops early if on_game returns false.
+void read_pgn_games(std::istream &in, const std::function<bool(PgnGame &&)> &on_game);
+
+// Score of the first player (Black, "x") for a PGN result token, or nullopt for unfinished games.
+[[nodiscard]] std::optional<double> black_score(const std::string &result);
+
+[[nodiscard]] std::optional<libataxx::Move> find_legal_move(const libataxx::Position &pos, const std::string &move);
+
+// Replays the game from its start position, calling on_move with the position before each move.
+// Stops at the first illegal move or when on_move returns false, and returns the last position reached.
+libataxx::Position replay_game(
+    const PgnGame &game,
+    const std::function<bool(const libataxx::Position &pos, const libataxx::Move &move, std::size_t ply)> &on_move);
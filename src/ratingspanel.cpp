@@ -0,0 +1,71 @@
+#include "ratingspanel.hpp"
+#include <QHeaderView>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+const QStringList fixed_columns = {"Engine", "Elo", "+/-", "Games", "Score"};
+
+}  // namespace
+
+RatingsPanel::RatingsPanel(QWidget *parent) : QWidget(parent) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    m_status = new QLabel(this);
+    m_table = new QTableWidget(0, fixed_columns.size(), this);
+
+    m_table->setHorizontalHeaderLabels(fixed_columns);
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    layout->addWidget(m_status);
+    layout->addWidget(m_table);
+    layout->setContentsMargins(0, 0, 0, 0);
+    setLayout(layout);
+    clear();
+}
+
+void RatingsPanel::clear() {
+    m_status->setText("No match played");
+    m_table->setRowCount(0);
+    m_table->setColumnCount(fixed_columns.size());
+}
+
+void RatingsPanel::set_ratings(const std::vector<std::string> &names, const RatingModel &model) {
+    const auto ratings = model.ratings();
+    std::vector<std::size_t> order(ratings.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&ratings](std::size_t a, std::size_t b) {
+        return ratings[a].elo > ratings[b].elo;
+    });
+
+    // Crosstable columns follow the rows, wins-draws-losses of the row engine
+    const int players = static_cast<int>(order.size());
+    auto headers = fixed_columns;
+    for (int i = 0; i < players; ++i) {
+        headers.append(QString::number(i + 1));
+    }
+    m_table->setRowCount(players);
+    m_table->setColumnCount(headers.size());
+    m_table->setHorizontalHeaderLabels(headers);
+
+    int games = 0;
+    for (int row = 0; row < players; ++row) {
+        const auto player = order[row];
+        const auto &r = ratings[player];
+        const double score = r.games > 0 ? 100.0 * r.points / r.games : 0.0;
+        games += r.games;
+        m_table->setItem(row, 0, new QTableWidgetItem(QString::fromStdString(names[player])));
+        m_table->setItem(row, 1, new QTableWidgetItem(QString::number(r.elo, 'f', 1)));
+        m_table->setItem(row, 2, new QTableWidgetItem(QString::number(r.error, 'f', 1)));
+        m_table->setItem(row, 3, new QTableWidgetItem(QString::number(r.games)));
+        m_table->setItem(row, 4, new QTableWidgetItem(QString::number(score, 'f', 1) + "%"));
+        for (int col = 0; col < players; ++col) {
+            const auto s = model.score(player, order[col]);
+            const auto text = row == col ? QString("-") : QString("%1-%2-%3").arg(s.wins).arg(s.draws).arg(s.losses);
+            m_table->setItem(row, fixed_columns.size() + col, new QTableWidgetItem(text));
+        }
+    }
+    m_status->setText(QString("%1 games, draw Elo %2").arg(games / 2).arg(model.draw_elo(), 0, 'f', 1));
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QLabel>
+#include <QTableWidget>
+#include <QWidget>
+#include <string>
+#include <vector>
+#include "match/ratings.hpp"
+
+// Rating list and crosstable of the running match.
+class RatingsPanel : public QWidget {
+    Q_OBJECT
+
+   public:
+    RatingsPanel(QWidget *parent = nullptr);
+
+    void set_ratings(const std::vector<std::string> &names, const RatingModel &model);
+    void clear();
+
+   private:
+    QLabel *m_status{nullptr};
+    QTableWidget *m_table{nullptr};
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <libataxx/position.hpp>
+#include "boardsymmetry.hpp"
+
+// Bitboard move generation for searches inside the GUI, in BoardBits square indices.
+
+constexpr std::uint64_t all_squares = (1ULL << board_squares) - 1;
+constexpr std::uint64_t file_a = 0x0040810204081ULL;
+constexpr std::uint64_t file_g = file_a << 6;
+
+// Squares one step away in any direction, including the squares themselves
+constexpr std::uint64_t dilate(std::uint64_t bb) {
+    const std::uint64_t horizontal = (bb | ((bb << 1) & ~file_a) | ((bb >> 1) & ~file_g)) & all_squares;
+    return (horizontal | (horizontal << 7) | (horizontal >> 7)) & all_squares;
+}
+
+using SquareMasks = std::array<std::uint64_t, board_squares>;
+
+constexpr SquareMasks make_single_move_masks() {
+    SquareMasks masks{};
+    for (int sq = 0; sq < board_squares; ++sq) {
+        masks[sq] = dilate(1ULL << sq) & ~(1ULL << sq);
+    }
+    return masks;
+}
+
+constexpr SquareMasks make_double_move_masks() {
+    SquareMasks masks{};
+    for (int sq = 0; sq < board_squares; ++sq) {
+        const auto near = dilate(1ULL << sq);
+        masks[sq] = dilate(near) & ~near;
+    }
+    return masks;
+}
+
+constexpr SquareMasks single_move_masks = make_single_move_masks();
+constexpr SquareMasks double_move_masks = make_double_move_masks();
+
+// Enough for any position
+constexpr int max_moves = 256;
+using MoveList = std::array<PackedMove, max_moves>;
+
+// Position relative to the side to move: the sides swap after every move.
+struct SearchBoard {
+    std::uint64_t us = 0;
+    std::uint64_t them = 0;
+    std::uint64_t gaps = 0;
+    int halfmoves = 0;
+
+    [[nodiscard]] static SearchBoard from(const libataxx::Position &pos) {
+        const auto bits = board_bits(pos);
+        const bool black = bits.turn == libataxx::Side::Black;
+        return SearchBoard{
+            .us = black ? bits.black : bits.white,
+            .them = black ? bits.white : bits.black,
+            .gaps = bits.gaps,
+            .halfmoves = pos.get_halfmoves(),
+        };
+    }
+
+    [[nodiscard]] std::uint64_t empty() const {
+        return ~(us | them | gaps) & all_squares;
+    }
+
+    // Colour swapped positions are the same to a search and share their key. The halfmove clock
+    // isn't part of it.
+    [[nodiscard]] std::uint64_t hash() const {
+        return mix(us ^ mix(them ^ mix(gaps ^ 0x9e3779b97f4a7c15ULL)));
+    }
+
+    [[nodiscard]] bool opponent_can_move() const {
+        return (dilate(dilate(them)) & empty()) != 0;
+    }
+
+    // Pieces of the side to move minus the opponent's
+    [[nodiscard]] int material() const {
+        return std::popcount(us) - std::popcount(them);
+    }
+
+    [[nodiscard]] int captures(PackedMove move) const {
+        return std::popcount(single_move_masks[move & 0xFF] & them);
+    }
+
+    // Singles first. Returns the number of moves, 0 if the side to move has to pass or the game is over.
+    int generate(MoveList &moves) const {
+        int n = 0;
+        const auto free = empty();
+        for (auto singles = dilate(us) & free; singles; singles &= singles - 1) {
+            const int to = std::countr_zero(singles);
+            moves[n++] = static_cast<PackedMove>((to << 8) | to);
+        }
+        for (auto pieces = us; pieces; pieces &= pieces - 1) {
+            const int from = std::countr_zero(pieces);
+            for (auto targets = double_move_masks[from] & free; targets; targets &= targets - 1) {
+                moves[n++] = static_cast<PackedMove>((from << 8) | std::countr_zero(targets));
+            }
+        }
+        return n;
+    }
+
+    [[nodiscard]] SearchBoard after(PackedMove move) const {
+        if (move == packed_pass) {
+            return SearchBoard{.us = them, .them = us, .gaps = gaps, .halfmoves = halfmoves + 1};
+        }
+        const int from = move >> 8;
+        const int to = move & 0xFF;
+        const std::uint64_t captured = single_move_masks[to] & them;
+        const bool single = from == to;
+        return SearchBoard{
+            .us = them ^ captured,
+            .them = (single ? us : us & ~(1ULL << from)) | (1ULL << to) | captured,
+            .gaps = gaps,
+            .halfmoves = single ? 0 : halfmoves + 1,
+        };
+    }
+
+   private:
+    [[nodiscard]] static constexpr std::uint64_t mix(std::uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+};
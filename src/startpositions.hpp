@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+inline const std::vector<std::string> start_positions = {"x5o/7/2-1-2/7/2-1-2/7/o5x x 0 1",
+                                                         "x5o/7/7/7/7/7/o5x x 0 1",
+                                                         "x5o/1-3-1/2-1-2/7/2-1-2/1-3-1/o5x x 0 1",
+                                                         "x5o/7/3-3/2-1-2/3-3/7/o5x x 0 1",
+                                                         "x5o/3-3/3-3/1--1--1/3-3/3-3/o5x x 0 1",
+                                                         "x2-2o/7/7/-5-/7/7/o2-2x x 0 1",
+                                                         "x2-2o/3-3/3-3/---1---/3-3/3-3/o2-2x x 0 1",
+                                                         "x5o/2-1-2/1-3-1/7/1-3-1/2-1-2/o5x x 0 1",
+                                                         "x1-1-1o/7/-5-/7/-5-/7/o1-1-1x x 0 1",
+                                                         "x2-2o/3-3/2---2/7/2---2/3-3/o2-2x x 0 1",
+                                                         "x2-2o/3-3/7/--3--/7/3-3/o2-2x x 0 1",
+                                                         "x1-1-1o/2-1-2/2-1-2/7/2-1-2/2-1-2/o1-1-1x x 0 1",
+                                                         "x5o/7/2-1-2/3-3/2-1-2/7/o5x x 0 1",
+                                                         "x5o/7/3-3/2---2/3-3/7/o5x x 0 1"};
@@ -0,0 +1,90 @@
+#include "datagen.hpp"
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include "../datagen/datagen.hpp"
+#include "../guisettings.hpp"
+#include "../metrics/metricsserver.hpp"
+#include "../startpositions.hpp"
+
+int datagen_main(const QStringList &arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generate training data from self-play games");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"engine", "Engine to play, give it twice for two engines playing each other.", "name"},
+        {"nodes", "Nodes searched per move.", "n", "5000"},
+        {"depth", "Depth searched per move, used instead of nodes.", "n", "0"},
+        {"games", "Number of games.", "n", "1000"},
+        {"min-plies", "Minimum number of random opening plies.", "n", "6"},
+        {"max-plies", "Maximum number of random opening plies.", "n", "10"},
+        {"base", "Base position, may be given several times. Defaults to the start positions.", "fen"},
+        {"out", "Output prefix, shards are written to <prefix>-<n>.bin.", "prefix", "data"},
+        {"shards", "Number of output files.", "n", "8"},
+        {"threads", "Number of threads, 0 for all cores.", "n", "0"},
+        {"seed", "Random seed.", "n", "0"},
+        {"skip-plies", "Plies after the opening whose positions are dropped.", "n", "8"},
+        {"max-captures", "Drop positions whose move captures more pieces.", "n", "3"},
+        {"dedup-mb", "Memory for the duplicate filter in MB, 0 keeps duplicates.", "mb", "256"},
+        {"metrics-port", "Serve Prometheus metrics on this port of localhost.", "port"},
+        {"settings", "Settings file with the engines.", "file", QString::fromStdString(settings_file_path())},
+    });
+    parser.process(arguments);
+
+    DatagenSettings settings;
+    settings.nodes = parser.value("nodes").toInt();
+    settings.depth = parser.value("depth").toInt();
+    settings.games = parser.value("games").toULongLong();
+    settings.min_plies = parser.value("min-plies").toInt();
+    settings.max_plies = parser.value("max-plies").toInt();
+    settings.out = parser.value("out").toStdString();
+    settings.shards = parser.value("shards").toInt();
+    settings.threads = parser.value("threads").toUInt();
+    settings.seed = parser.value("seed").toULongLong();
+    settings.skip_plies = parser.value("skip-plies").toInt();
+    settings.max_captures = parser.value("max-captures").toInt();
+    settings.dedup_mb = parser.value("dedup-mb").toULongLong();
+    for (const auto &fen : parser.values("base")) {
+        settings.base_fens.push_back(fen.toStdString());
+    }
+    if (settings.base_fens.empty()) {
+        settings.base_fens = start_positions;
+    }
+
+    const auto gui_settings = GuiSettings(parser.value("settings").toStdString());
+    for (const auto &engine : parser.values("engine")) {
+        const auto name = engine.toStdString();
+        const auto iter = std::find_if(gui_settings.engines.begin(), gui_settings.engines.end(), [&name](const auto &e) {
+            return e.name == name;
+        });
+        if (iter == gui_settings.engines.end()) {
+            throw std::invalid_argument("No engine named " + name + " in the settings file");
+        }
+        settings.engines.push_back(*iter);
+    }
+
+    std::unique_ptr<MetricsServer> metrics;
+    if (parser.isSet("metrics-port")) {
+        metrics = std::make_unique<MetricsServer>(
+            MetricsSettings{.port = static_cast<std::uint16_t>(parser.value("metrics-port").toUInt())});
+    }
+
+    QTextStream out(stdout);
+    QElapsedTimer timer;
+    timer.start();
+    const auto rate = [&timer](std::uint64_t positions) {
+        return positions * 3600000 / std::max<qint64>(timer.elapsed(), 1);
+    };
+    const auto total = generate_data(settings, [&out, &rate](const DatagenProgress &progress) {
+        if (progress.games % 100 == 0) {
+            out << progress.games << " games, " << progress.positions << " positions, " << progress.filtered << " filtered, "
+                << rate(progress.positions) << " positions/hour" << Qt::endl;
+        }
+    });
+    out << "Wrote " << total.positions << " positions from " << total.games << " games to " << parser.value("out")
+        << "-*.bin" << Qt::endl;
+    return total.games == settings.games ? 0 : 1;
+}
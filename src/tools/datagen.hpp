@@ -0,0 +1,6 @@
+#pragma once
+
+#include <QStringList>
+
+// Plays fixed node or depth self-play games and writes every position as binary training data.
+int datagen_main(const QStringList &arguments);
@@ -0,0 +1,64 @@
+#include "genopenings.hpp"
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <algorithm>
+#include <stdexcept>
+#include "../guisettings.hpp"
+#include "../openings/openinggenerator.hpp"
+#include "../startpositions.hpp"
+
+int genopenings_main(const QStringList &arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generate unique random openings");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"count", "Number of openings.", "n", "1000"},
+        {"min-plies", "Minimum number of random plies.", "n", "4"},
+        {"max-plies", "Maximum number of random plies.", "n", "8"},
+        {"base", "Base position, may be given several times. Defaults to the start positions.", "fen"},
+        {"out", "Output file.", "file", "openings.epd"},
+        {"threads", "Number of threads, 0 for all cores.", "n", "0"},
+        {"seed", "Random seed.", "n", "0"},
+        {"engine", "Keep only openings this engine scores as balanced.", "name"},
+        {"nodes", "Nodes the engine searches per opening.", "n", "10000"},
+        {"max-score", "Largest absolute score in centipawns that counts as balanced.", "cp", "100"},
+        {"settings", "Settings file with the engine.", "file", QString::fromStdString(settings_file_path())},
+    });
+    parser.process(arguments);
+
+    OpeningGeneratorSettings settings;
+    settings.count = parser.value("count").toULongLong();
+    settings.min_plies = parser.value("min-plies").toInt();
+    settings.max_plies = parser.value("max-plies").toInt();
+    settings.threads = parser.value("threads").toUInt();
+    settings.seed = parser.value("seed").toULongLong();
+    settings.nodes = parser.value("nodes").toInt();
+    settings.max_score = parser.value("max-score").toInt();
+    for (const auto &fen : parser.values("base")) {
+        settings.base_fens.push_back(fen.toStdString());
+    }
+    if (settings.base_fens.empty()) {
+        settings.base_fens = start_positions;
+    }
+
+    if (parser.isSet("engine")) {
+        const auto name = parser.value("engine").toStdString();
+        const auto gui_settings = GuiSettings(parser.value("settings").toStdString());
+        const auto iter = std::find_if(gui_settings.engines.begin(), gui_settings.engines.end(), [&name](const auto &e) {
+            return e.name == name;
+        });
+        if (iter == gui_settings.engines.end()) {
+            throw std::invalid_argument("No engine named " + name + " in the settings file");
+        }
+        settings.engine = *iter;
+    }
+
+    QTextStream out(stdout);
+    const auto written = generate_openings(settings, parser.value("out").toStdString(), [&out](std::size_t n) {
+        if (n % 1000 == 0) {
+            out << n << " openings" << Qt::endl;
+        }
+    });
+    out << "Wrote " << written << " openings to " << parser.value("out") << Qt::endl;
+    return written == settings.count ? 0 : 1;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <QStringList>
+
+// Generates unique random openings, optionally only balanced ones, and writes them as EPD.
+int genopenings_main(const QStringList &arguments);
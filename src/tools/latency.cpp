@@ -0,0 +1,65 @@
+#include "latency.hpp"
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <vector>
+#include "../engines/latencyprofiler.hpp"
+#include "../guisettings.hpp"
+
+int latency_main(const QStringList &arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measure the protocol latency of engines");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"engine", "Engine to profile, may be given several times. Defaults to all engines.", "name"},
+        {"startups", "Number of engine starts.", "n", "100"},
+        {"isready", "Number of isready round trips.", "n", "5000"},
+        {"go", "Number of go movetime 1 searches.", "n", "2000"},
+        {"settings", "Settings file with the engines.", "file", QString::fromStdString(settings_file_path())},
+    });
+    parser.process(arguments);
+
+    LatencySettings settings;
+    settings.startups = parser.value("startups").toULongLong();
+    settings.isready = parser.value("isready").toULongLong();
+    settings.go = parser.value("go").toULongLong();
+
+    const auto gui_settings = GuiSettings(parser.value("settings").toStdString());
+    std::vector<EngineSettings> engines;
+    for (const auto &engine : parser.values("engine")) {
+        const auto name = engine.toStdString();
+        const auto iter = std::find_if(gui_settings.engines.begin(), gui_settings.engines.end(), [&name](const auto &e) {
+            return e.name == name;
+        });
+        if (iter == gui_settings.engines.end()) {
+            throw std::invalid_argument("No engine named " + name + " in the settings file");
+        }
+        engines.push_back(*iter);
+    }
+    if (engines.empty()) {
+        engines = gui_settings.engines;
+    }
+
+    QTextStream out(stdout);
+    int failed = 0;
+    for (const auto &engine : engines) {
+        const auto name = QString::fromStdString(engine.name);
+        out << name << Qt::endl;
+        try {
+            const auto latency = profile_latency(engine, settings, [&out](const std::string &probe) {
+                out << "  running " << QString::fromStdString(probe) << "..." << Qt::endl;
+            });
+            out << QString::fromStdString(latency_table("probe",
+                                                        {{"startup", latency.startup},
+                                                         {"isready", latency.isready},
+                                                         {"go", latency.go}}))
+                << Qt::flush;
+        } catch (const std::exception &e) {
+            out << "  failed: " << e.what() << Qt::endl;
+            ++failed;
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <QStringList>
+
+// Measures how fast engines start and answer isready and go, to find the shortest time control they can play.
+int latency_main(const QStringList &arguments);
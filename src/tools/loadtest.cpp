@@ -0,0 +1,188 @@
+#include "loadtest.hpp"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTextStream>
+#include <QTimer>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../engines/enginefactory.hpp"
+#include "../engines/engineproxy.hpp"
+#include "../engines/latencyprofiler.hpp"
+#include "../engines/scoreengine.hpp"
+#include "../engines/watchdogengine.hpp"
+#include "../match/matchrunner.hpp"
+#include "../startpositions.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Samples {
+    std::mutex mutex;
+    std::vector<std::chrono::microseconds> values;
+
+    void add(std::chrono::microseconds value) {
+        std::lock_guard lock(mutex);
+        values.push_back(value);
+    }
+};
+
+// Time the game waits for every move, watchdog included
+class MoveTimer : public EngineProxy {
+   public:
+    [[nodiscard]] MoveTimer(std::shared_ptr<Engine> engine, std::shared_ptr<Samples> samples)
+        : EngineProxy(std::move(engine)), m_samples(std::move(samples)) {
+    }
+
+    [[nodiscard]] auto go(const SearchSettings &settings) -> std::string override {
+        const auto start = Clock::now();
+        auto move = m_engine->go(settings);
+        m_samples->add(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start));
+        return move;
+    }
+
+   private:
+    std::shared_ptr<Samples> m_samples;
+};
+
+}  // namespace
+
+int loadtest_main(const QStringList &arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Load test the match runner with mock engines");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"games", "Number of games.", "n", "2000"},
+        {"concurrency", "Games played at the same time, 0 for all cores.", "n", "0"},
+        {"time", "Time per game in ms.", "ms", "10000"},
+        {"inc", "Increment per move in ms.", "ms", "100"},
+        {"latency", "Median think time of the engines in ms.", "ms", "2"},
+        {"spread", "Sigma of the log-normal think time, 0 for a fixed think time.", "sigma", "0.5"},
+        {"info", "Info lines per second the engines send while thinking.", "n", "1000"},
+        {"crash", "Probability that an engine crashes in a search.", "p", "0.0005"},
+        {"hang", "Probability that an engine hangs in a search.", "p", "0.0005"},
+        {"grace", "Time a hung engine gets beyond its clock in ms.", "ms", "100"},
+        {"pgn", "Write the games to this file.", "file"},
+        {"seed", "Random seed.", "n", "1"},
+        {"in-process", "Run the engines inside this process instead of as UAI engine processes."},
+    });
+    parser.process(arguments);
+
+    const int time = parser.value("time").toInt();
+    const int inc = parser.value("inc").toInt();
+    std::vector<EngineSettings> engines(2);
+    for (std::size_t i = 0; i < engines.size(); ++i) {
+        auto &engine = engines[i];
+        engine.name = i == 0 ? "Mock A" : "Mock B";
+        if (parser.isSet("in-process")) {
+            engine.builtin = "mock";
+        } else {
+            // This binary's "mock" tool, so the games go through the pipes and the protocol
+            engine.path = QCoreApplication::applicationFilePath().toStdString();
+            engine.arguments = "mock";
+            engine.proto = EngineProtocol::UAI;
+        }
+        engine.tc = SearchSettings::as_time(time, time, inc, inc);
+        for (const auto &name : {"latency", "spread", "info", "crash", "hang"}) {
+            engine.options.emplace_back(name, parser.value(name).toStdString());
+        }
+        engine.options.emplace_back("seed", std::to_string(parser.value("seed").toULongLong() + i));
+    }
+
+    MatchSettings settings;
+    settings.games = parser.value("games").toInt();
+    settings.concurrency = parser.value("concurrency").toInt();
+    if (settings.concurrency <= 0) {
+        settings.concurrency = std::max(1, QThread::idealThreadCount());
+    }
+    settings.pgn_out = parser.value("pgn").toStdString();
+
+    const WatchdogSettings watchdog{.grace = std::chrono::milliseconds(parser.value("grace").toInt())};
+    auto move_times = std::make_shared<Samples>();
+    std::atomic<std::uint64_t> info_lines = 0;
+    // Numbers the engine processes like the in-process engines number themselves
+    std::atomic<std::uint64_t> next_instance = 0;
+    MatchRunner runner(settings, engines, [&](const EngineSettings &base) -> std::shared_ptr<Engine> {
+        auto engine = base;
+        if (engine.builtin.empty()) {
+            engine.arguments += " --instance " + std::to_string(next_instance++);
+        }
+        auto scores = std::make_shared<ScoreTracker>();
+        const auto recv = [&info_lines, scores](const std::string &line) {
+            if (line.starts_with("info")) {
+                info_lines.fetch_add(1, std::memory_order_relaxed);
+            }
+            scores->on_line(line);
+        };
+        std::shared_ptr<Engine> e = std::make_shared<WatchdogEngine>(create_engine(engine, {}, recv), watchdog);
+        e = std::make_shared<MoveTimer>(e, move_times);
+        return std::make_shared<ScoreEngine>(e, scores);
+    });
+
+    QTextStream out(stdout);
+    std::uint64_t finished = 0;
+    std::uint64_t failed = 0;
+    std::uint64_t moves = 0;
+    QObject::connect(&runner, &MatchRunner::new_move, [&moves](int, GameThingy) {
+        ++moves;
+    });
+    QObject::connect(&runner, &MatchRunner::game_finished, [&](int, MatchGame, GameThingy, GameResult) {
+        if (++finished % 500 == 0) {
+            out << finished << " games" << Qt::endl;
+        }
+    });
+    QObject::connect(&runner, &MatchRunner::game_failed, [&failed](int, MatchGame, QString, GameResult) {
+        ++failed;
+    });
+
+    // How late a timer fires on the GUI thread, the delay every signal from the games sees on top
+    constexpr auto lag_interval = std::chrono::milliseconds(10);
+    std::vector<std::chrono::microseconds> lags;
+    QTimer lag_timer;
+    lag_timer.setTimerType(Qt::PreciseTimer);
+    auto last_tick = Clock::now();
+    QObject::connect(&lag_timer, &QTimer::timeout, [&]() {
+        const auto now = Clock::now();
+        const auto late = std::chrono::duration_cast<std::chrono::microseconds>(now - last_tick - lag_interval);
+        lags.push_back(std::max(late, std::chrono::microseconds(0)));
+        last_tick = now;
+    });
+
+    QEventLoop loop;
+    QObject::connect(&runner, &MatchRunner::match_finished, &loop, &QEventLoop::quit);
+    QElapsedTimer timer;
+    timer.start();
+    runner.start(start_positions.front());
+    lag_timer.start(lag_interval);
+    // A match without games is over before the loop runs
+    if (runner.is_running()) {
+        loop.exec();
+    }
+    lag_timer.stop();
+
+    const double seconds = std::max<qint64>(timer.elapsed(), 1) / 1000.0;
+    out << finished << " games and " << failed << " failed games in " << QString::number(seconds, 'f', 1) << " s on "
+        << settings.concurrency << " slots" << Qt::endl;
+    out << "  " << QString::number(finished * 60.0 / seconds, 'f', 0) << " games/min, "
+        << QString::number(moves / seconds, 'f', 0) << " moves/s, " << QString::number(info_lines / seconds, 'f', 0)
+        << " info lines/s" << Qt::endl;
+    int crashes = 0;
+    int hangs = 0;
+    for (const auto &failures : runner.failures()) {
+        crashes += failures.crashes;
+        hangs += failures.hangs;
+    }
+    out << "  " << crashes << " crashes, " << hangs << " hangs" << Qt::endl;
+    out << QString::fromStdString(latency_table("latency",
+                                                {{"move", latency_stats(std::move(move_times->values))},
+                                                 {"gui lag", latency_stats(std::move(lags))}}))
+        << Qt::flush;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <QStringList>
+
+// Plays a match between two mock engines as fast as they go and reports throughput and tail latencies.
+int loadtest_main(const QStringList &arguments);
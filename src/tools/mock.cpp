@@ -0,0 +1,150 @@
+#include "mock.hpp"
+#include <QCommandLineParser>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <libataxx/position.hpp>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "../engines/mockengine.hpp"
+
+namespace {
+
+const std::string startpos = "x5o/7/7/7/7/7/o5x x 0 1";
+
+std::mutex output_mutex;
+
+void send(const std::string &line) {
+    std::lock_guard lock(output_mutex);
+    std::cout << line << std::endl;
+}
+
+// "position startpos|fen <fen> [moves <move>...]", moves that aren't legal are ignored
+libataxx::Position parse_position(std::istringstream &in) {
+    std::string token;
+    in >> token;
+    std::string fen = startpos;
+    if (token == "fen") {
+        fen.clear();
+        while (in >> token && token != "moves") {
+            fen += (fen.empty() ? "" : " ") + token;
+        }
+    } else {
+        in >> token;
+    }
+    libataxx::Position pos(fen);
+    if (token != "moves") {
+        return pos;
+    }
+    while (in >> token) {
+        for (const auto &move : pos.legal_moves()) {
+            if (static_cast<std::string>(move) == token) {
+                pos.makemove(move);
+                break;
+            }
+        }
+    }
+    return pos;
+}
+
+SearchSettings parse_go(std::istringstream &in) {
+    SearchSettings settings;
+    std::string token;
+    int value = 0;
+    while (in >> token >> value) {
+        if (token == "btime") {
+            settings.btime = value;
+        } else if (token == "wtime") {
+            settings.wtime = value;
+        } else if (token == "binc") {
+            settings.binc = value;
+        } else if (token == "winc") {
+            settings.winc = value;
+        } else if (token == "movetime") {
+            settings.type = SearchSettings::Type::Movetime;
+            settings.movetime = value;
+        } else if (token == "nodes") {
+            settings.type = SearchSettings::Type::Nodes;
+            settings.nodes = value;
+        } else if (token == "depth") {
+            settings.type = SearchSettings::Type::Depth;
+            settings.ply = value;
+        }
+    }
+    return settings;
+}
+
+}  // namespace
+
+int mock_main(const QStringList &arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Mock engine speaking UAI on stdin and stdout, see the mock engine options");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"instance", "Number of the engine, engines with the same seed and instance make the same choices.", "n"},
+    });
+    parser.process(arguments);
+
+    std::optional<std::uint64_t> instance;
+    if (parser.isSet("instance")) {
+        instance = parser.value("instance").toULongLong();
+    }
+    MockEngine engine(send, instance);
+    std::thread search;
+    const auto wait_for_search = [&engine, &search](bool stop) {
+        if (search.joinable()) {
+            if (stop) {
+                engine.stop();
+            }
+            search.join();
+        }
+    };
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream in(line);
+        std::string command;
+        in >> command;
+        if (command == "uai") {
+            send("id name Mock");
+            send("id author AtaxxGUI");
+            for (const auto &option : {"latency", "spread", "info", "crash", "hang", "seed"}) {
+                send(std::string("option name ") + option + " type string default");
+            }
+            send("uaiok");
+        } else if (command == "isready") {
+            send("readyok");
+        } else if (command == "setoption") {
+            std::string token, name, value;
+            in >> token >> name >> token;
+            std::getline(in >> std::ws, value);
+            engine.set_option(name, value);
+        } else if (command == "uainewgame") {
+            wait_for_search(true);
+            engine.newgame();
+        } else if (command == "position") {
+            wait_for_search(true);
+            engine.position(parse_position(in));
+        } else if (command == "go") {
+            wait_for_search(true);
+            search = std::thread([&engine, settings = parse_go(in)]() {
+                try {
+                    send("bestmove " + engine.go(settings));
+                } catch (const std::exception &) {
+                    // A crash is a crash, the GUI has to see the process die
+                    std::_Exit(EXIT_FAILURE);
+                }
+            });
+        } else if (command == "stop") {
+            wait_for_search(true);
+        } else if (command == "quit") {
+            break;
+        }
+    }
+    wait_for_search(true);
+    return 0;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <QStringList>
+
+// Runs the mock engine as a UAI engine on stdin and stdout, so load tests go through engine processes.
+int mock_main(const QStringList &arguments);
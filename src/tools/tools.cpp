@@ -0,0 +1,35 @@
+#include "tools.hpp"
+#include <QTextStream>
+#include <exception>
+#include <functional>
+#include <map>
+#include "datagen.hpp"
+#include "genopenings.hpp"
+#include "latency.hpp"
+#include "loadtest.hpp"
+#include "mock.hpp"
+
+namespace {
+
+const std::map<QString, std::function<int(const QStringList &)>> tools = {
+    {"genopenings", genopenings_main},
+    {"datagen", datagen_main},
+    {"latency", latency_main},
+    {"loadtest", loadtest_main},
+    {"mock", mock_main},
+};
+
+}  // namespace
+
+bool is_tool(const QString &name) {
+    return tools.contains(name);
+}
+
+int run_tool(const QStringList &arguments) {
+    try {
+        return tools.at(arguments.at(0))(arguments);
+    } catch (const std::exception &e) {
+        QTextStream(stderr) << arguments.at(0) << ": " << e.what() << Qt::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+// Command line tools run without a window, "AtaxxGUI <tool> [options]"
+[[nodiscard]] bool is_tool(const QString &name);
+
+// arguments[0] is the tool name. Returns the exit code.
+int run_tool(const QStringList &arguments);
@@ -0,0 +1,118 @@
+#include "tracer.hpp"
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+Tracer &Tracer::instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::start() {
+    std::lock_guard lock(m_mutex);
+    for (auto &buffer : m_buffers) {
+        m_retired.push_back(std::move(buffer));
+    }
+    m_buffers.clear();
+    m_start = Clock::now();
+    m_session.fetch_add(1, std::memory_order_release);
+    m_enabled.store(true, std::memory_order_release);
+}
+
+Tracer::ThreadBuffer &Tracer::buffer() {
+    thread_local ThreadBuffer *cached = nullptr;
+    thread_local std::uint64_t cached_session = 0;
+    const auto session = m_session.load(std::memory_order_acquire);
+    if (cached == nullptr || cached_session != session) {
+        std::lock_guard lock(m_mutex);
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->track = static_cast<int>(m_buffers.size()) + 1;
+        cached = buffer.get();
+        cached_session = session;
+        m_buffers.push_back(std::move(buffer));
+    }
+    return *cached;
+}
+
+void Tracer::name_thread(const std::string &name) {
+    if (!enabled()) {
+        return;
+    }
+    auto &own = buffer();
+    std::lock_guard lock(m_mutex);
+    own.name = name;
+}
+
+void Tracer::complete(const char *name,
+                      const char *category,
+                      Clock::time_point begin,
+                      Clock::time_point end,
+                      std::string detail) {
+    if (!m_enabled.load(std::memory_order_acquire)) {
+        return;
+    }
+    auto &own = buffer();
+    Chunk *chunk = own.last;
+    auto size = chunk->size.load(std::memory_order_relaxed);
+    if (size == Chunk::capacity) {
+        auto *next = new Chunk;
+        chunk->next.store(next, std::memory_order_release);
+        own.last = chunk = next;
+        size = 0;
+    }
+
+    auto &event = chunk->events[size];
+    event.name = name;
+    event.category = category;
+    event.begin_us = std::chrono::duration_cast<std::chrono::microseconds>(begin - m_start).count();
+    event.duration_us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    event.detail = std::move(detail);
+    // Publishes the event to write()
+    chunk->size.store(size + 1, std::memory_order_release);
+}
+
+bool Tracer::write(const std::string &path) {
+    m_enabled.store(false, std::memory_order_release);
+    std::lock_guard lock(m_mutex);
+
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        return false;
+    }
+    // One event per line, the trace of a long match doesn't have to fit in memory twice
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    const auto put = [&out, &first](const nlohmann::json &event) {
+        out << (first ? "" : ",\n") << event.dump();
+        first = false;
+    };
+    for (const auto &buffer : m_buffers) {
+        const auto name = buffer->name.empty() ? "Thread " + std::to_string(buffer->track) : buffer->name;
+        put({{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", buffer->track}, {"args", {{"name", name}}}});
+        put({{"name", "thread_sort_index"},
+             {"ph", "M"},
+             {"pid", 1},
+             {"tid", buffer->track},
+             {"args", {{"sort_index", buffer->track}}}});
+
+        for (const Chunk *chunk = &buffer->first; chunk != nullptr;
+             chunk = chunk->next.load(std::memory_order_acquire)) {
+            const auto size = chunk->size.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < size; ++i) {
+                const auto &e = chunk->events[i];
+                nlohmann::json event = {{"name", e.name},
+                                        {"cat", e.category},
+                                        {"ph", "X"},
+                                        {"ts", e.begin_us},
+                                        {"dur", e.duration_us},
+                                        {"pid", 1},
+                                        {"tid", buffer->track}};
+                if (!e.detail.empty()) {
+                    event["args"] = {{"detail", e.detail}};
+                }
+                put(event);
+            }
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Timeline of a match in the Chrome Trace Event format, for Perfetto or about://tracing.
+// Recording is off until start(). Every thread appends to a buffer of its own without locking,
+// the buffers are only read by write() at the end. Each thread is a track, named by name_thread().
+class Tracer {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    [[nodiscard]] static Tracer &instance();
+
+    // Drops what an earlier run recorded and starts recording
+    void start();
+
+    [[nodiscard]] bool enabled() const {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    void name_thread(const std::string &name);
+
+    // name and category must be string literals, detail is shown with the event
+    void complete(const char *name,
+                  const char *category,
+                  Clock::time_point begin,
+                  Clock::time_point end,
+                  std::string detail = {});
+
+    // Stops recording and writes everything recorded since start(). Returns false if the file
+    // couldn't be written.
+    bool write(const std::string &path);
+
+   private:
+    struct Event {
+        const char *name = nullptr;
+        const char *category = nullptr;
+        std::int64_t begin_us = 0;
+        std::int64_t duration_us = 0;
+        std::string detail;
+    };
+
+    // Filled by its thread only. A full chunk gets a successor, so events never move.
+    struct Chunk {
+        static constexpr std::size_t capacity = 4096;
+
+        ~Chunk() {
+            delete next.load();
+        }
+
+        std::array<Event, capacity> events;
+        std::atomic<std::size_t> size = 0;
+        std::atomic<Chunk *> next = nullptr;
+    };
+
+    struct ThreadBuffer {
+        int track = 0;
+        // Guarded by the tracer's mutex
+        std::string name;
+        Chunk first;
+        Chunk *last = &first;
+    };
+
+    Tracer() = default;
+    [[nodiscard]] ThreadBuffer &buffer();
+
+    std::atomic<bool> m_enabled = false;
+    // Buffers of earlier runs stay alive, a thread may still hold on to one
+    std::atomic<std::uint64_t> m_session = 0;
+    Clock::time_point m_start;
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_retired;
+};
+
+// Records the time from construction to destruction, if the tracer is on
+class TraceSpan {
+   public:
+    TraceSpan(const char *name, const char *category, std::string detail = {})
+        : m_name(name), m_category(category), m_enabled(Tracer::instance().enabled()) {
+        if (m_enabled) {
+            m_detail = std::move(detail);
+            m_begin = Tracer::Clock::now();
+        }
+    }
+
+    ~TraceSpan() {
+        if (m_enabled) {
+            Tracer::instance().complete(m_name, m_category, m_begin, Tracer::Clock::now(), std::move(m_detail));
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+   private:
+    const char *m_name;
+    const char *m_category;
+    bool m_enabled;
+    std::string m_detail;
+    Tracer::Clock::time_point m_begin;
+};